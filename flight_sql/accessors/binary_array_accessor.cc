@@ -9,6 +9,13 @@
 #include <arrow/array.h>
 #include <algorithm>
 #include <cstdint>
+#include <odbcabstraction/cpu_features.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
 
 namespace driver {
 namespace flight_sql {
@@ -25,6 +32,10 @@ inline RowStatus MoveSingleCellToBinaryBuffer(ColumnBinding *binding,
 
   const char *value = array->Value(arrow_row).data();
   size_t size_in_bytes = array->value_length(arrow_row);
+  if (binding->max_length > 0) {
+    // Values cut at the maximum length aren't reported as truncated.
+    size_in_bytes = std::min(size_in_bytes, binding->max_length);
+  }
 
   size_t remaining_length = static_cast<size_t>(size_in_bytes - value_offset);
   size_t value_length =
@@ -52,8 +63,180 @@ inline RowStatus MoveSingleCellToBinaryBuffer(ColumnBinding *binding,
   return result;
 }
 
+constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+void HexEncodeScalar(const uint8_t *input, size_t length, char *output) {
+  for (size_t i = 0; i < length; ++i) {
+    output[2 * i] = HEX_DIGITS[input[i] >> 4];
+    output[2 * i + 1] = HEX_DIGITS[input[i] & 0x0F];
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE4_2 __attribute__((target("sse4.2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE4_2
+#define TARGET_AVX2
+#endif
+
+// Looks up the digits for the high and low nibbles of 16 bytes at once and
+// interleaves them.
+TARGET_SSE4_2
+void HexEncodeSse42(const uint8_t *input, size_t length, char *output) {
+  const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(HEX_DIGITS));
+  const __m128i low_mask = _mm_set1_epi8(0x0F);
+
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask));
+    const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, low_mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * i), _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+  }
+  HexEncodeScalar(input + i, length - i, output + 2 * i);
+}
+
+TARGET_AVX2
+void HexEncodeAvx2(const uint8_t *input, size_t length, char *output) {
+  const __m256i digits = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(HEX_DIGITS)));
+  const __m256i low_mask = _mm256_set1_epi8(0x0F);
+
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    const __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_mask));
+    const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, low_mask));
+    // Unpacking works within 128-bit lanes, so the lanes are put back in order.
+    const __m256i first = _mm256_unpacklo_epi8(high, low);
+    const __m256i second = _mm256_unpackhi_epi8(high, low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + 2 * i),
+                        _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + 2 * i + 32),
+                        _mm256_permute2x128_si256(first, second, 0x31));
+  }
+  HexEncodeSse42(input + i, length - i, output + 2 * i);
+}
+#elif defined(__aarch64__) || defined(_M_ARM64)
+void HexEncodeNeon(const uint8_t *input, size_t length, char *output) {
+  const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t *>(HEX_DIGITS));
+  const uint8x16_t low_mask = vdupq_n_u8(0x0F);
+
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t bytes = vld1q_u8(input + i);
+    uint8x16x2_t chars;
+    chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(bytes, 4));
+    chars.val[1] = vqtbl1q_u8(digits, vandq_u8(bytes, low_mask));
+    // Stores both registers interleaved.
+    vst2q_u8(reinterpret_cast<uint8_t *>(output + 2 * i), chars);
+  }
+  HexEncodeScalar(input + i, length - i, output + 2 * i);
+}
+#endif
+
+const KernelDispatcher<HexEncodeFunction> HEX_ENCODE_KERNELS = {
+    {SimdLevel_NONE, HexEncodeScalar},
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    {SimdLevel_SSE4_2, HexEncodeSse42},
+    {SimdLevel_AVX2, HexEncodeAvx2},
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    {SimdLevel_NEON, HexEncodeNeon},
+#endif
+};
+
+/// Writes `count` hex characters of `bytes`, starting at character
+/// `first_char`, which may fall in the middle of a byte.
+template <typename CHAR_TYPE>
+void WriteHexChars(HexEncodeFunction hex_encode, const uint8_t *bytes, size_t first_char,
+                   size_t count, CHAR_TYPE *output, std::vector<char> &hex_buffer) {
+  size_t written = 0;
+  size_t byte = first_char / 2;
+  if (count > 0 && first_char % 2 == 1) {
+    output[written++] = HEX_DIGITS[bytes[byte++] & 0x0F];
+  }
+
+  const size_t whole_bytes = (count - written) / 2;
+  if (sizeof(CHAR_TYPE) == sizeof(char)) {
+    hex_encode(bytes + byte, whole_bytes, reinterpret_cast<char *>(output + written));
+  } else {
+    hex_buffer.resize(whole_bytes * 2);
+    hex_encode(bytes + byte, whole_bytes, hex_buffer.data());
+    std::copy(hex_buffer.begin(), hex_buffer.end(), output + written);
+  }
+  written += whole_bytes * 2;
+  byte += whole_bytes;
+
+  if (written < count) {
+    output[written] = HEX_DIGITS[bytes[byte] >> 4];
+  }
+}
+
+template <typename CHAR_TYPE>
+inline RowStatus MoveSingleCellToHexBuffer(HexEncodeFunction hex_encode,
+                                           std::vector<char> &hex_buffer,
+                                           ColumnBinding *binding,
+                                           BinaryArray *array, int64_t arrow_row, int64_t i,
+                                           int64_t &value_offset, bool update_value_offset,
+                                           odbcabstraction::Diagnostics &diagnostics) {
+  RowStatus result = odbcabstraction::RowStatus_SUCCESS;
+
+  const auto value = array->GetView(arrow_row);
+  const auto *bytes = reinterpret_cast<const uint8_t *>(value.data());
+
+  // Offsets are kept in bytes of the output, like for strings.
+  size_t total_chars = value.size() * 2;
+  if (binding->max_length > 0) {
+    // Values cut at the maximum length aren't reported as truncated.
+    total_chars = std::min(total_chars, binding->max_length / sizeof(CHAR_TYPE));
+  }
+  const size_t first_char = static_cast<size_t>(value_offset) / sizeof(CHAR_TYPE);
+  const size_t remaining_chars = total_chars - first_char;
+  const size_t capacity_chars = binding->buffer_length / sizeof(CHAR_TYPE);
+
+  size_t chars_to_write;
+  if (capacity_chars > remaining_chars) {
+    // The entire remainder fits along with the NUL terminator.
+    chars_to_write = remaining_chars;
+    if (update_value_offset) {
+      value_offset = -1;
+    }
+  } else {
+    result = odbcabstraction::RowStatus_SUCCESS_WITH_INFO;
+    diagnostics.AddTruncationWarning();
+    chars_to_write = capacity_chars > 0 ? capacity_chars - 1 : 0;
+    if (update_value_offset) {
+      value_offset += static_cast<int64_t>(chars_to_write * sizeof(CHAR_TYPE));
+    }
+  }
+
+  if (capacity_chars > 0) {
+    auto *char_buffer = reinterpret_cast<CHAR_TYPE *>(
+        static_cast<char *>(binding->buffer) + i * binding->buffer_length);
+    WriteHexChars(hex_encode, bytes, first_char, chars_to_write, char_buffer, hex_buffer);
+    char_buffer[chars_to_write] = '\0';
+  }
+
+  if (binding->strlen_buffer) {
+    binding->strlen_buffer[i] = static_cast<ssize_t>(remaining_chars * sizeof(CHAR_TYPE));
+  }
+
+  return result;
+}
+
 } // namespace
 
+HexEncodeFunction GetHexEncodeKernel() {
+  return HEX_ENCODE_KERNELS.Get();
+}
+
+void HexEncode(const uint8_t *input, size_t length, char *output) {
+  GetHexEncodeKernel()(input, length, output);
+}
+
 template <CDataType TARGET_TYPE>
 BinaryArrayFlightSqlAccessor<TARGET_TYPE>::BinaryArrayFlightSqlAccessor(
     Array *array)
@@ -75,5 +258,31 @@ size_t BinaryArrayFlightSqlAccessor<TARGET_TYPE>::GetCellLength_impl(ColumnBindi
 
 template class BinaryArrayFlightSqlAccessor<odbcabstraction::CDataType_BINARY>;
 
+template <CDataType TARGET_TYPE, typename CHAR_TYPE>
+HexBinaryArrayFlightSqlAccessor<TARGET_TYPE, CHAR_TYPE>::HexBinaryArrayFlightSqlAccessor(
+    Array *array)
+    : FlightSqlAccessor<BinaryArray, TARGET_TYPE,
+                        HexBinaryArrayFlightSqlAccessor<TARGET_TYPE, CHAR_TYPE>>(array),
+      hex_encode_(GetHexEncodeKernel()) {}
+
+template <CDataType TARGET_TYPE, typename CHAR_TYPE>
+RowStatus HexBinaryArrayFlightSqlAccessor<TARGET_TYPE, CHAR_TYPE>::MoveSingleCell_impl(
+    ColumnBinding *binding, int64_t arrow_row, int64_t i, int64_t &value_offset,
+    bool update_value_offset, odbcabstraction::Diagnostics &diagnostics) {
+  return MoveSingleCellToHexBuffer<CHAR_TYPE>(hex_encode_, hex_buffer_, binding, this->GetArray(),
+                                              arrow_row, i, value_offset, update_value_offset,
+                                              diagnostics);
+}
+
+template <CDataType TARGET_TYPE, typename CHAR_TYPE>
+size_t HexBinaryArrayFlightSqlAccessor<TARGET_TYPE, CHAR_TYPE>::GetCellLength_impl(
+    ColumnBinding *binding) const {
+  return binding->buffer_length;
+}
+
+template class HexBinaryArrayFlightSqlAccessor<odbcabstraction::CDataType_CHAR, char>;
+template class HexBinaryArrayFlightSqlAccessor<odbcabstraction::CDataType_WCHAR, char16_t>;
+template class HexBinaryArrayFlightSqlAccessor<odbcabstraction::CDataType_WCHAR, char32_t>;
+
 } // namespace flight_sql
 } // namespace driver
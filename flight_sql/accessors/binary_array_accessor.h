@@ -9,6 +9,8 @@
 #include "arrow/type_fwd.h"
 #include "types.h"
 #include <odbcabstraction/types.h>
+#include <odbcabstraction/encoding.h>
+#include <vector>
 
 namespace driver {
 namespace flight_sql {
@@ -16,6 +18,10 @@ namespace flight_sql {
 using namespace arrow;
 using namespace odbcabstraction;
 
+/// \brief A kernel writing `length` bytes as `2 * length` uppercase hex
+/// characters.
+typedef void (*HexEncodeFunction)(const uint8_t *input, size_t length, char *output);
+
 template <CDataType TARGET_TYPE>
 class BinaryArrayFlightSqlAccessor
     : public FlightSqlAccessor<BinaryArray, TARGET_TYPE,
@@ -30,5 +36,46 @@ public:
   size_t GetCellLength_impl(ColumnBinding *binding) const;
 };
 
+/// \brief Accessor writing binary values as uppercase hex text, two
+/// characters per byte, as ODBC specifies for binary data bound as character.
+template <CDataType TARGET_TYPE, typename CHAR_TYPE>
+class HexBinaryArrayFlightSqlAccessor
+    : public FlightSqlAccessor<BinaryArray, TARGET_TYPE,
+                               HexBinaryArrayFlightSqlAccessor<TARGET_TYPE, CHAR_TYPE>> {
+public:
+  explicit HexBinaryArrayFlightSqlAccessor(Array *array);
+
+  RowStatus MoveSingleCell_impl(ColumnBinding *binding, int64_t arrow_row, int64_t i,
+                                int64_t &value_offset, bool update_value_offset,
+                                odbcabstraction::Diagnostics &diagnostics);
+
+  size_t GetCellLength_impl(ColumnBinding *binding) const;
+
+private:
+  // Resolved once, rather than for every cell.
+  HexEncodeFunction hex_encode_;
+  // Holds hex text before it's widened, when CHAR_TYPE is wider than char.
+  std::vector<char> hex_buffer_;
+};
+
+inline Accessor* CreateWCharHexBinaryArrayAccessor(arrow::Array *array) {
+  switch(GetSqlWCharSize()) {
+    case sizeof(char16_t):
+      return new HexBinaryArrayFlightSqlAccessor<CDataType_WCHAR, char16_t>(array);
+    case sizeof(char32_t):
+      return new HexBinaryArrayFlightSqlAccessor<CDataType_WCHAR, char32_t>(array);
+    default:
+      assert(false);
+      throw DriverException("Encoding is unsupported, SQLWCHAR size: " + std::to_string(GetSqlWCharSize()));
+  }
+}
+
+/// \brief Returns the best hex encoding kernel for the enabled SIMD level.
+HexEncodeFunction GetHexEncodeKernel();
+
+/// \brief Writes `length` bytes as `2 * length` uppercase hex characters,
+/// using the best kernel for the enabled SIMD level.
+void HexEncode(const uint8_t *input, size_t length, char *output);
+
 } // namespace flight_sql
 } // namespace driver
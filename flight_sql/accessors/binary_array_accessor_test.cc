@@ -8,6 +8,8 @@
 #include "arrow/testing/builder.h"
 #include "binary_array_accessor.h"
 #include "gtest/gtest.h"
+#include <iomanip>
+#include <odbcabstraction/cpu_features.h>
 
 namespace driver {
 namespace flight_sql {
@@ -15,6 +17,19 @@ namespace flight_sql {
 using namespace arrow;
 using namespace odbcabstraction;
 
+namespace {
+/// \brief Restores the SIMD level cap a test changed, so later tests run with
+/// the level they started with.
+class SimdLevelRestorer {
+public:
+  SimdLevelRestorer() : previous_(GetSimdLevel()) {}
+  ~SimdLevelRestorer() { SetMaxSimdLevel(previous_); }
+
+private:
+  SimdLevel previous_;
+};
+} // namespace
+
 TEST(BinaryArrayAccessor, Test_CDataType_BINARY_Basic) {
   std::vector<std::string> values = {"foo", "barx", "baz123"};
   std::shared_ptr<Array> array;
@@ -88,5 +103,117 @@ TEST(BinaryArrayAccessor, Test_CDataType_BINARY_Truncation) {
   ASSERT_EQ(values[0], ss.str());
 }
 
+TEST(BinaryArrayAccessor, Test_CDataType_BINARY_MaxLength) {
+  std::vector<std::string> values = {"ABCDEFABCDEF"};
+  std::shared_ptr<Array> array;
+  ArrayFromVector<BinaryType, std::string>(values, &array);
+
+  BinaryArrayFlightSqlAccessor<CDataType_BINARY> accessor(array.get());
+
+  size_t max_strlen = 64;
+  std::vector<char> buffer(max_strlen);
+  std::vector<ssize_t> strlen_buffer(1);
+
+  ColumnBinding binding(CDataType_BINARY, 0, 0, buffer.data(), max_strlen,
+                        strlen_buffer.data(), 5);
+
+  int64_t value_offset = 0;
+  odbcabstraction::Diagnostics diagnostics("Foo", "Foo", OdbcVersion::V_3);
+  ASSERT_EQ(1, accessor.GetColumnarData(&binding, 0, 1, value_offset, true, diagnostics, nullptr));
+
+  // The value is cut at the maximum length without a truncation warning.
+  ASSERT_EQ(5, strlen_buffer[0]);
+  ASSERT_EQ("ABCDE", std::string(buffer.data(), buffer.data() + strlen_buffer[0]));
+  ASSERT_EQ(-1, value_offset);
+  ASSERT_FALSE(diagnostics.HasWarning());
+}
+
+TEST(BinaryArrayAccessor, Test_CDataType_CHAR_Hex) {
+  std::vector<std::string> values = {std::string("\x00\x1f\xab\xff", 4), ""};
+  std::shared_ptr<Array> array;
+  ArrayFromVector<BinaryType, std::string>(values, &array);
+
+  HexBinaryArrayFlightSqlAccessor<CDataType_CHAR, char> accessor(array.get());
+
+  size_t max_strlen = 16;
+  std::vector<char> buffer(values.size() * max_strlen);
+  std::vector<ssize_t> strlen_buffer(values.size());
+
+  ColumnBinding binding(CDataType_CHAR, 0, 0, buffer.data(), max_strlen,
+                        strlen_buffer.data());
+
+  int64_t value_offset = 0;
+  odbcabstraction::Diagnostics diagnostics("Foo", "Foo", OdbcVersion::V_3);
+  ASSERT_EQ(values.size(),
+            accessor.GetColumnarData(&binding, 0, values.size(), value_offset, false, diagnostics, nullptr));
+
+  ASSERT_EQ(8, strlen_buffer[0]);
+  ASSERT_EQ("001FABFF", std::string(buffer.data()));
+  ASSERT_EQ(0, strlen_buffer[1]);
+  ASSERT_EQ("", std::string(buffer.data() + max_strlen));
+}
+
+TEST(BinaryArrayAccessor, Test_CDataType_CHAR_HexTruncation) {
+  // Long enough to go through the vectorized kernels.
+  std::string value;
+  for (int i = 0; i < 50; ++i) {
+    value.push_back(static_cast<char>(i * 7));
+  }
+  std::vector<std::string> values = {value};
+  std::shared_ptr<Array> array;
+  ArrayFromVector<BinaryType, std::string>(values, &array);
+
+  std::stringstream expected;
+  expected << std::hex << std::uppercase << std::setfill('0');
+  for (unsigned char c : value) {
+    expected << std::setw(2) << static_cast<int>(c);
+  }
+
+  HexBinaryArrayFlightSqlAccessor<CDataType_CHAR, char> accessor(array.get());
+
+  // An even buffer size leaves an odd number of digits per chunk, so chunks
+  // start in the middle of bytes.
+  size_t max_strlen = 8;
+  std::vector<char> buffer(max_strlen);
+  std::vector<ssize_t> strlen_buffer(1);
+
+  ColumnBinding binding(CDataType_CHAR, 0, 0, buffer.data(), max_strlen,
+                        strlen_buffer.data());
+
+  std::stringstream ss;
+  int64_t value_offset = 0;
+
+  odbcabstraction::Diagnostics diagnostics("Foo", "Foo", OdbcVersion::V_3);
+  do {
+    diagnostics.Clear();
+    int64_t original_value_offset = value_offset;
+    ASSERT_EQ(1, accessor.GetColumnarData(&binding, 0, 1, value_offset, true, diagnostics, nullptr));
+    ASSERT_EQ(expected.str().length() - original_value_offset, strlen_buffer[0]);
+
+    ss << buffer.data();
+  } while (value_offset != -1);
+
+  ASSERT_EQ(expected.str(), ss.str());
+}
+
+TEST(BinaryArrayAccessor, Test_HexEncodeKernelsMatch) {
+  std::vector<uint8_t> input(100);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<uint8_t>(i * 37 + 11);
+  }
+
+  SimdLevelRestorer restorer;
+  std::vector<char> expected(input.size() * 2);
+  SetMaxSimdLevel(SimdLevel_NONE);
+  HexEncode(input.data(), input.size(), expected.data());
+
+  for (auto level : {SimdLevel_SSE4_2, SimdLevel_AVX2, SimdLevel_AVX512, SimdLevel_NEON}) {
+    std::vector<char> actual(input.size() * 2);
+    SetMaxSimdLevel(level);
+    HexEncode(input.data(), input.size(), actual.data());
+    ASSERT_EQ(expected, actual) << SimdLevelToString(level);
+  }
+}
+
 } // namespace flight_sql
 } // namespace driver
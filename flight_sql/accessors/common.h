@@ -9,6 +9,8 @@
 #include "types.h"
 #include <arrow/array.h>
 #include <arrow/scalar.h>
+#include <arrow/util/bit_run_reader.h>
+#include <arrow/util/bitmap_ops.h>
 #include <odbcabstraction/types.h>
 #include <odbcabstraction/diagnostics.h>
 #include <algorithm>
@@ -20,28 +22,48 @@ namespace flight_sql {
 using namespace arrow;
 using namespace odbcabstraction;
 
+/// \brief Returns the length of the longest prefix of a UTF-8 string that
+/// fits `max_length` bytes without splitting a character.
+inline size_t Utf8PrefixLength(const char *value, size_t length, size_t max_length) {
+  if (length <= max_length) {
+    return length;
+  }
+
+  size_t prefix_length = max_length;
+  // Back off continuation bytes (10xxxxxx) of a character cut in the middle.
+  while (prefix_length > 0 && (static_cast<uint8_t>(value[prefix_length]) & 0xC0) == 0x80) {
+    --prefix_length;
+  }
+  return prefix_length;
+}
+
 template <typename ARRAY_TYPE>
 inline size_t CopyFromArrayValuesToBinding(ARRAY_TYPE* array,
                                            ColumnBinding *binding,
                                            int64_t starting_row, int64_t cells) {
   constexpr ssize_t element_size = sizeof(typename ARRAY_TYPE::value_type);
 
+  const uint8_t *validity = array->null_bitmap_data();
+  // Null-free arrays don't need their validity bitmap looked at.
+  const bool has_nulls = validity != nullptr && array->null_count() > 0;
+
   if (binding->strlen_buffer) {
-    for (int64_t i = 0; i < cells; ++i) {
-      int64_t current_row = starting_row + i;
-      if (array->IsNull(current_row)) {
-        binding->strlen_buffer[i] = NULL_DATA;
-      } else {
-        binding->strlen_buffer[i] = element_size;
-      }
-    }
-  } else {
-    // Duplicate this loop to avoid null checks within the loop.
-    for (int64_t i = starting_row; i < starting_row + cells; ++i) {
-      if (array->IsNull(i)) {
-        throw odbcabstraction::NullWithoutIndicatorException();
-      }
+    if (!has_nulls) {
+      std::fill(binding->strlen_buffer, binding->strlen_buffer + cells, element_size);
+    } else {
+      // Walk the bitmap in runs of valid values rather than bit by bit.
+      ssize_t *strlen_buffer = binding->strlen_buffer;
+      std::fill(strlen_buffer, strlen_buffer + cells, static_cast<ssize_t>(NULL_DATA));
+      arrow::internal::VisitSetBitRunsVoid(
+          validity, array->offset() + starting_row, cells,
+          [strlen_buffer](int64_t position, int64_t length) {
+            std::fill(strlen_buffer + position, strlen_buffer + position + length,
+                      static_cast<ssize_t>(element_size));
+          });
     }
+  } else if (has_nulls &&
+             arrow::internal::CountSetBits(validity, array->offset() + starting_row, cells) != cells) {
+    throw odbcabstraction::NullWithoutIndicatorException();
   }
 
   // Copy the entire array to the bound ODBC buffers.
@@ -14,3 +14,4 @@
 #include "decimal_array_accessor.h"
 #include "primitive_array_accessor.h"
 #include "string_array_accessor.h"
+#include "string_view_array_accessor.h"
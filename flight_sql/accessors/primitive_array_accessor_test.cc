@@ -84,5 +84,39 @@ TEST(PrimitiveArrayFlightSqlAccessor, Test_DoubleArray_CDataType_DOUBLE) {
   TestPrimitiveArraySqlAccessor<DoubleArray, CDataType_DOUBLE>();
 }
 
+TEST(PrimitiveArrayFlightSqlAccessor, Test_Int32ArrayWithNulls_CDataType_SLONG) {
+  std::vector<bool> is_valid = {true, false, false, true, true, false, true};
+  std::vector<int32_t> values = {0, 1, 2, 3, 4, 5, 6};
+
+  std::shared_ptr<Array> array;
+  ArrayFromVector<Int32Type, int32_t>(is_valid, values, &array);
+
+  PrimitiveArrayFlightSqlAccessor<Int32Array, CDataType_SLONG> accessor(array.get());
+
+  // Start past the first row so the bitmap is read from an unaligned position.
+  std::vector<int32_t> buffer(values.size() - 1);
+  std::vector<ssize_t> strlen_buffer(values.size() - 1);
+  ColumnBinding binding(CDataType_SLONG, 0, 0, buffer.data(), 0, strlen_buffer.data());
+
+  int64_t value_offset = 0;
+  driver::odbcabstraction::Diagnostics diagnostics("Dummy", "Dummy", odbcabstraction::V_3);
+  ASSERT_EQ(buffer.size(),
+            accessor.GetColumnarData(&binding, 1, buffer.size(), value_offset, false, diagnostics, nullptr));
+
+  for (int i = 0; i < buffer.size(); ++i) {
+    if (is_valid[i + 1]) {
+      ASSERT_EQ(sizeof(int32_t), strlen_buffer[i]);
+      ASSERT_EQ(values[i + 1], buffer[i]);
+    } else {
+      ASSERT_EQ(odbcabstraction::NULL_DATA, strlen_buffer[i]);
+    }
+  }
+
+  ColumnBinding binding_without_indicator(CDataType_SLONG, 0, 0, buffer.data(), 0, nullptr);
+  ASSERT_EQ(2, accessor.GetColumnarData(&binding_without_indicator, 3, 2, value_offset, false, diagnostics, nullptr));
+  ASSERT_THROW(accessor.GetColumnarData(&binding_without_indicator, 4, 2, value_offset, false, diagnostics, nullptr),
+               odbcabstraction::NullWithoutIndicatorException);
+}
+
 } // namespace flight_sql
 } // namespace driver
@@ -7,6 +7,8 @@
 #include "string_array_accessor.h"
 
 #include <arrow/array.h>
+#include <algorithm>
+#include "common.h"
 #include <boost/locale.hpp>
 #include <odbcabstraction/encoding.h>
 
@@ -43,9 +45,20 @@ inline RowStatus MoveSingleCellToCharBuffer(std::vector<uint8_t> &buffer,
 
   // Arrow strings come as UTF-8
   const char *raw_value = array->Value(arrow_row).data();
-  const size_t raw_value_length = array->value_length(arrow_row);
+  size_t raw_value_length = array->value_length(arrow_row);
   const void *value;
 
+  // With SQL_ATTR_MAX_LENGTH set, only the part of the value that can be
+  // returned is transcoded. Each character unit written takes at least one
+  // and at most four bytes of UTF-8.
+  const size_t max_length = binding->max_length;
+  if (max_length > 0) {
+    const size_t max_raw_length = sizeof(CHAR_TYPE) > sizeof(char)
+                                      ? (max_length / sizeof(CHAR_TYPE)) * 4
+                                      : max_length;
+    raw_value_length = Utf8PrefixLength(raw_value, raw_value_length, max_raw_length);
+  }
+
   size_t size_in_bytes;
   if (sizeof(CHAR_TYPE) > sizeof(char)) {
     if (last_retrieved_arrow_row != arrow_row) {
@@ -72,6 +85,11 @@ inline RowStatus MoveSingleCellToCharBuffer(std::vector<uint8_t> &buffer,
 #endif
   }
 
+  if (max_length > 0) {
+    // Values cut at the maximum length aren't reported as truncated.
+    size_in_bytes = std::min(size_in_bytes, (max_length / sizeof(CHAR_TYPE)) * sizeof(CHAR_TYPE));
+  }
+
   size_t remaining_length = static_cast<size_t>(size_in_bytes - value_offset);
   size_t value_length =
       std::min(remaining_length,
@@ -73,6 +73,36 @@ TEST(StringArrayAccessor, Test_CDataType_CHAR_Truncation) {
   ASSERT_EQ(values[0], ss.str());
 }
 
+TEST(StringArrayAccessor, Test_CDataType_CHAR_MaxLength) {
+  std::vector<std::string> values = {"foo", "barbaz"};
+  std::shared_ptr<Array> array;
+  ArrayFromVector<StringType, std::string>(values, &array);
+
+  StringArrayFlightSqlAccessor<CDataType_CHAR, char> accessor(array.get());
+
+  size_t max_strlen = 64;
+  std::vector<char> buffer(values.size() * max_strlen);
+  std::vector<ssize_t> strlen_buffer(values.size());
+  std::vector<uint16_t> row_status(values.size());
+
+  ColumnBinding binding(CDataType_CHAR, 0, 0, buffer.data(), max_strlen,
+                        strlen_buffer.data(), 4);
+
+  int64_t value_offset = 0;
+  odbcabstraction::Diagnostics diagnostics("Foo", "Foo", OdbcVersion::V_3);
+  ASSERT_EQ(values.size(),
+            accessor.GetColumnarData(&binding, 0, values.size(), value_offset, false, diagnostics,
+                                     row_status.data()));
+
+  // Values are cut at the maximum length without a truncation warning.
+  ASSERT_EQ(3, strlen_buffer[0]);
+  ASSERT_EQ("foo", std::string(buffer.data()));
+  ASSERT_EQ(4, strlen_buffer[1]);
+  ASSERT_EQ("barb", std::string(buffer.data() + max_strlen));
+  ASSERT_EQ(odbcabstraction::RowStatus_SUCCESS, row_status[1]);
+  ASSERT_FALSE(diagnostics.HasWarning());
+}
+
 TEST(StringArrayAccessor, Test_CDataType_WCHAR_Basic) {
   std::vector<std::string> values = {"foo", "barx", "baz123"};
   std::shared_ptr<Array> array;
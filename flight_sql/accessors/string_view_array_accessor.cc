@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "string_view_array_accessor.h"
+
+#include <arrow/array.h>
+#include <algorithm>
+
+namespace driver {
+namespace flight_sql {
+
+using namespace arrow;
+using namespace odbcabstraction;
+
+template <typename ARROW_ARRAY>
+StringViewArrayFlightSqlAccessor<ARROW_ARRAY>::StringViewArrayFlightSqlAccessor(
+    Array *array)
+    : FlightSqlAccessor<ARROW_ARRAY, CDataType_STRING_VIEW,
+                        StringViewArrayFlightSqlAccessor<ARROW_ARRAY>>(array) {}
+
+template <typename ARROW_ARRAY>
+RowStatus StringViewArrayFlightSqlAccessor<ARROW_ARRAY>::MoveSingleCell_impl(
+    ColumnBinding *binding, int64_t arrow_row, int64_t i, int64_t &value_offset,
+    bool update_value_offset, odbcabstraction::Diagnostics &diagnostics) {
+  const auto value = this->GetArray()->GetView(arrow_row);
+
+  auto *view = static_cast<STRING_VIEW_STRUCT *>(binding->buffer) + i;
+  view->data = value.data();
+  view->length = static_cast<int64_t>(
+      binding->max_length > 0 ? std::min(value.size(), binding->max_length) : value.size());
+
+  if (binding->strlen_buffer) {
+    binding->strlen_buffer[i] = static_cast<ssize_t>(sizeof(STRING_VIEW_STRUCT));
+  }
+
+  // The whole value is always returned at once.
+  if (update_value_offset) {
+    value_offset = -1;
+  }
+
+  return odbcabstraction::RowStatus_SUCCESS;
+}
+
+template <typename ARROW_ARRAY>
+size_t StringViewArrayFlightSqlAccessor<ARROW_ARRAY>::GetCellLength_impl(
+    ColumnBinding *binding) const {
+  return sizeof(STRING_VIEW_STRUCT);
+}
+
+template class StringViewArrayFlightSqlAccessor<StringArray>;
+template class StringViewArrayFlightSqlAccessor<BinaryArray>;
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#pragma once
+
+#include "arrow/type_fwd.h"
+#include "types.h"
+#include <odbcabstraction/types.h>
+
+namespace driver {
+namespace flight_sql {
+
+using namespace arrow;
+using namespace odbcabstraction;
+
+/// \brief Accessor writing STRING_VIEW_STRUCT values pointing into the array's
+/// data buffer, so string and binary values are returned without copies or
+/// truncation.
+template <typename ARROW_ARRAY>
+class StringViewArrayFlightSqlAccessor
+    : public FlightSqlAccessor<ARROW_ARRAY, CDataType_STRING_VIEW,
+                               StringViewArrayFlightSqlAccessor<ARROW_ARRAY>> {
+public:
+  explicit StringViewArrayFlightSqlAccessor(Array *array);
+
+  RowStatus MoveSingleCell_impl(ColumnBinding *binding, int64_t arrow_row, int64_t i,
+                                int64_t &value_offset, bool update_value_offset,
+                                odbcabstraction::Diagnostics &diagnostics);
+
+  size_t GetCellLength_impl(ColumnBinding *binding) const;
+};
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "arrow/testing/gtest_util.h"
+#include "arrow/testing/builder.h"
+#include "string_view_array_accessor.h"
+#include "gtest/gtest.h"
+
+namespace driver {
+namespace flight_sql {
+
+using namespace arrow;
+using namespace odbcabstraction;
+
+TEST(StringViewArrayAccessor, Test_CDataType_STRING_VIEW_Basic) {
+  std::vector<std::string> values = {"foo", "", "a much longer value than the others"};
+  std::shared_ptr<Array> array;
+  ArrayFromVector<StringType, std::string>(values, &array);
+
+  StringViewArrayFlightSqlAccessor<StringArray> accessor(array.get());
+
+  std::vector<STRING_VIEW_STRUCT> buffer(values.size());
+  std::vector<ssize_t> strlen_buffer(values.size());
+
+  ColumnBinding binding(CDataType_STRING_VIEW, 0, 0, buffer.data(), 0,
+                        strlen_buffer.data());
+
+  int64_t value_offset = 0;
+  odbcabstraction::Diagnostics diagnostics("Foo", "Foo", OdbcVersion::V_3);
+  ASSERT_EQ(values.size(),
+            accessor.GetColumnarData(&binding, 0, values.size(), value_offset, false, diagnostics, nullptr));
+
+  const auto &string_array = internal::checked_cast<const StringArray &>(*array);
+  for (int i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(sizeof(STRING_VIEW_STRUCT), strlen_buffer[i]);
+    ASSERT_EQ(values[i], std::string(buffer[i].data, buffer[i].length));
+    // Values point into the array instead of being copied.
+    ASSERT_EQ(string_array.GetView(i).data(), buffer[i].data);
+  }
+  ASSERT_EQ(0, diagnostics.GetRecordCount());
+}
+
+TEST(StringViewArrayAccessor, Test_CDataType_STRING_VIEW_BinaryWithNulls) {
+  std::vector<std::string> values = {"ab", "", "cde"};
+  std::vector<bool> is_valid = {true, false, true};
+  std::shared_ptr<Array> array;
+  ArrayFromVector<BinaryType, std::string>(is_valid, values, &array);
+
+  StringViewArrayFlightSqlAccessor<BinaryArray> accessor(array.get());
+
+  std::vector<STRING_VIEW_STRUCT> buffer(values.size());
+  std::vector<ssize_t> strlen_buffer(values.size());
+
+  ColumnBinding binding(CDataType_STRING_VIEW, 0, 0, buffer.data(), 0,
+                        strlen_buffer.data());
+
+  int64_t value_offset = 0;
+  odbcabstraction::Diagnostics diagnostics("Foo", "Foo", OdbcVersion::V_3);
+  ASSERT_EQ(values.size(),
+            accessor.GetColumnarData(&binding, 0, values.size(), value_offset, false, diagnostics, nullptr));
+
+  ASSERT_EQ("ab", std::string(buffer[0].data, buffer[0].length));
+  ASSERT_EQ(odbcabstraction::NULL_DATA, strlen_buffer[1]);
+  ASSERT_EQ("cde", std::string(buffer[2].data, buffer[2].length));
+}
+
+} // namespace flight_sql
+} // namespace driver
@@ -31,14 +31,17 @@ struct ColumnBinding {
   CDataType target_type;
   int precision;
   int scale;
+  // Maximum bytes returned for character and binary values, 0 means no limit.
+  // Longer values are cut without a truncation warning (SQL_ATTR_MAX_LENGTH).
+  size_t max_length = 0;
 
   ColumnBinding() = default;
 
   ColumnBinding(CDataType target_type, int precision, int scale, void *buffer,
-                size_t buffer_length, ssize_t *strlen_buffer)
+                size_t buffer_length, ssize_t *strlen_buffer, size_t max_length = 0)
       : target_type(target_type), precision(precision), scale(scale),
         buffer(buffer), buffer_length(buffer_length),
-        strlen_buffer(strlen_buffer) {}
+        strlen_buffer(strlen_buffer), max_length(max_length) {}
 };
 
 /// \brief Accessor interface meant to provide a way of populating data of a
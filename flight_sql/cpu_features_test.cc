@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include <odbcabstraction/cpu_features.h>
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+namespace driver {
+namespace odbcabstraction {
+
+namespace {
+SimdLevel ReturnNone() { return SimdLevel_NONE; }
+SimdLevel ReturnSse42() { return SimdLevel_SSE4_2; }
+SimdLevel ReturnAvx2() { return SimdLevel_AVX2; }
+SimdLevel ReturnAvx512() { return SimdLevel_AVX512; }
+SimdLevel ReturnNeon() { return SimdLevel_NEON; }
+} // namespace
+
+/// The tests change the process-wide cap, which is put back afterwards.
+class CpuFeatures : public ::testing::Test {
+protected:
+  void SetUp() override { initial_level_ = GetSimdLevel(); }
+
+  void TearDown() override { SetMaxSimdLevel(initial_level_); }
+
+private:
+  SimdLevel initial_level_;
+};
+
+TEST_F(CpuFeatures, DetectsLevelOfArchitecture) {
+  const SimdLevel detected = GetDetectedSimdLevel();
+#if defined(__aarch64__) || defined(_M_ARM64)
+  ASSERT_EQ(SimdLevel_NEON, detected);
+#elif defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  ASSERT_NE(SimdLevel_NEON, detected);
+#else
+  ASSERT_EQ(SimdLevel_NONE, detected);
+#endif
+  ASSERT_EQ(detected, GetDetectedSimdLevel());
+}
+
+TEST_F(CpuFeatures, CapLowersLevel) {
+  SetMaxSimdLevel(SimdLevel_NONE);
+  ASSERT_EQ(SimdLevel_NONE, GetSimdLevel());
+  ASSERT_TRUE(IsSimdLevelEnabled(SimdLevel_NONE));
+  for (auto level : {SimdLevel_SSE4_2, SimdLevel_AVX2, SimdLevel_AVX512, SimdLevel_NEON}) {
+    ASSERT_FALSE(IsSimdLevelEnabled(level)) << SimdLevelToString(level);
+  }
+
+  SetMaxSimdLevel(GetDetectedSimdLevel());
+  ASSERT_EQ(GetDetectedSimdLevel(), GetSimdLevel());
+  ASSERT_TRUE(IsSimdLevelEnabled(GetDetectedSimdLevel()));
+}
+
+TEST_F(CpuFeatures, CapIsClampedToDetectedLevel) {
+  const SimdLevel detected = GetDetectedSimdLevel();
+
+  SetMaxSimdLevel(SimdLevel_AVX512);
+  ASSERT_EQ(detected == SimdLevel_NEON ? SimdLevel_NONE : std::min(SimdLevel_AVX512, detected),
+            GetSimdLevel());
+
+  // NEON and the x86 tiers never imply each other.
+  SetMaxSimdLevel(SimdLevel_NEON);
+  ASSERT_EQ(detected == SimdLevel_NEON ? SimdLevel_NEON : SimdLevel_NONE, GetSimdLevel());
+  if (detected != SimdLevel_NEON) {
+    ASSERT_FALSE(IsSimdLevelEnabled(SimdLevel_NEON));
+  } else {
+    ASSERT_FALSE(IsSimdLevelEnabled(SimdLevel_SSE4_2));
+  }
+}
+
+TEST_F(CpuFeatures, DispatcherFollowsCap) {
+  const KernelDispatcher<SimdLevel (*)()> dispatcher = {
+      {SimdLevel_NONE, ReturnNone},     {SimdLevel_SSE4_2, ReturnSse42},
+      {SimdLevel_AVX2, ReturnAvx2},     {SimdLevel_AVX512, ReturnAvx512},
+      {SimdLevel_NEON, ReturnNeon}};
+
+  for (auto level : {SimdLevel_NONE, SimdLevel_SSE4_2, SimdLevel_AVX2, SimdLevel_AVX512,
+                     SimdLevel_NEON, SimdLevel_NONE}) {
+    SetMaxSimdLevel(level);
+    // Repeated lookups return the cached implementation.
+    ASSERT_EQ(GetSimdLevel(), dispatcher.Get()()) << SimdLevelToString(level);
+    ASSERT_EQ(GetSimdLevel(), dispatcher.Get()()) << SimdLevelToString(level);
+  }
+}
+
+TEST_F(CpuFeatures, DispatcherFallsBackToScalar) {
+  const KernelDispatcher<SimdLevel (*)()> dispatcher = {{SimdLevel_NONE, ReturnNone}};
+
+  SetMaxSimdLevel(GetDetectedSimdLevel());
+  ASSERT_EQ(SimdLevel_NONE, dispatcher.Get()());
+}
+
+TEST_F(CpuFeatures, ParsesLevelNames) {
+  for (auto level : {SimdLevel_NONE, SimdLevel_SSE4_2, SimdLevel_AVX2, SimdLevel_AVX512,
+                     SimdLevel_NEON}) {
+    ASSERT_EQ(level, ParseSimdLevel(SimdLevelToString(level)).value());
+  }
+  ASSERT_EQ(SimdLevel_AVX2, ParseSimdLevel("AVX2").value());
+  ASSERT_EQ(SimdLevel_SSE4_2, ParseSimdLevel("sse4_2").value());
+  ASSERT_FALSE(ParseSimdLevel("avx3"));
+}
+
+} // namespace odbcabstraction
+} // namespace driver
@@ -44,6 +44,7 @@ using arrow::flight::FlightClientOptions;
 using arrow::flight::Location;
 using arrow::flight::TimeoutDuration;
 using arrow::flight::sql::FlightSqlClient;
+using arrow::flight::sql::PreparedStatement;
 using driver::odbcabstraction::AsBool;
 using driver::odbcabstraction::Connection;
 using driver::odbcabstraction::DriverException;
@@ -69,7 +70,12 @@ const std::string FlightSqlConnection::STRING_COLUMN_LENGTH = "StringColumnLengt
 const std::string FlightSqlConnection::USE_EXTENDED_FLIGHTSQL_BUFFER = "UseExtendedFlightSQLBuffer";
 const std::string FlightSqlConnection::USE_WIDE_CHAR = "UseWideChar";
 const std::string FlightSqlConnection::CHUNK_BUFFER_CAPACITY = "ChunkBufferCapacity";
+const std::string FlightSqlConnection::SPILL_THRESHOLD_MB = "SpillThresholdMB";
+const std::string FlightSqlConnection::SPLIT_STATEMENT_BATCHES = "SplitStatementBatches";
 const std::string FlightSqlConnection::HIDE_SQL_TABLES_LISTING = "HideSQLTablesListing";
+const std::string FlightSqlConnection::FLATTEN_STRUCT_COLUMNS = "FlattenStructColumns";
+const std::string FlightSqlConnection::PREPARED_STATEMENT_CACHE_SIZE = "PreparedStatementCacheSize";
+const std::string FlightSqlConnection::PREPARED_STATEMENT_PROMOTION_THRESHOLD = "PreparedStatementPromotionThreshold";
 const std::string FlightSqlConnection::SEND_PING_FRAME = "SendPingFrame";
 const std::string FlightSqlConnection::PING_FRAME_INTERVAL_MS = "PingFrameIntervalMilliseconds";
 const std::string FlightSqlConnection::PING_FRAME_TIMEOUT_MS = "PingFrameTimeoutMilliseconds";
@@ -83,7 +89,10 @@ const std::vector<std::string> FlightSqlConnection::ALL_KEYS = {
     FlightSqlConnection::USE_WIDE_CHAR, FlightSqlConnection::USE_EXTENDED_FLIGHTSQL_BUFFER, FlightSqlConnection::CHUNK_BUFFER_CAPACITY,
     FlightSqlConnection::HIDE_SQL_TABLES_LISTING, FlightSqlConnection::SEND_PING_FRAME,
     FlightSqlConnection::PING_FRAME_INTERVAL_MS, FlightSqlConnection::PING_FRAME_TIMEOUT_MS,
-    FlightSqlConnection::MAX_PINGS_WITHOUT_DATA};
+    FlightSqlConnection::MAX_PINGS_WITHOUT_DATA, FlightSqlConnection::FLATTEN_STRUCT_COLUMNS,
+    FlightSqlConnection::PREPARED_STATEMENT_CACHE_SIZE,
+    FlightSqlConnection::PREPARED_STATEMENT_PROMOTION_THRESHOLD, FlightSqlConnection::SPILL_THRESHOLD_MB,
+    FlightSqlConnection::SPLIT_STATEMENT_BATCHES};
 
 namespace {
 
@@ -142,7 +151,12 @@ const std::set<std::string, odbcabstraction::CaseInsensitiveComparator> BUILT_IN
     FlightSqlConnection::SEND_PING_FRAME,
     FlightSqlConnection::PING_FRAME_INTERVAL_MS,
     FlightSqlConnection::PING_FRAME_TIMEOUT_MS,
-    FlightSqlConnection::MAX_PINGS_WITHOUT_DATA
+    FlightSqlConnection::MAX_PINGS_WITHOUT_DATA,
+    FlightSqlConnection::FLATTEN_STRUCT_COLUMNS,
+    FlightSqlConnection::PREPARED_STATEMENT_CACHE_SIZE,
+    FlightSqlConnection::PREPARED_STATEMENT_PROMOTION_THRESHOLD,
+    FlightSqlConnection::SPILL_THRESHOLD_MB,
+    FlightSqlConnection::SPLIT_STATEMENT_BATCHES
 };
 
 Connection::ConnPropertyMap::const_iterator
@@ -194,9 +208,20 @@ void FlightSqlConnection::Connect(const ConnPropertyMap &properties,
       FlightSqlAuthMethod::FromProperties(flight_client, properties);
     auth_method->Authenticate(*this, call_options_);
 
-    sql_client_.reset(new FlightSqlClient(std::move(flight_client)));
+    flight_client_ = std::move(flight_client);
+    sql_client_.reset(new FlightSqlClient(flight_client_));
+    query_canceller_ = std::make_shared<QueryCanceller>(flight_client_);
     closed_ = false;
 
+    size_t cache_size = GetPreparedStatementCacheSize(properties);
+    if (cache_size > 0) {
+      prepared_statement_cache_ = std::make_shared<PreparedStatementCache>(
+          cache_size, GetPreparedStatementPromotionThreshold(properties),
+          [](const std::shared_ptr<PreparedStatement> &prepared_statement) {
+            ARROW_UNUSED(prepared_statement->Close());
+          });
+    }
+
     // Note: This should likely come from Flight instead of being from the
     // connection properties to allow reporting a user for other auth mechanisms
     // and also decouple the database user from user credentials.
@@ -205,9 +230,19 @@ void FlightSqlConnection::Connect(const ConnPropertyMap &properties,
 
     PopulateMetadataSettings(properties);
     PopulateCallOptions(properties);
+
+    // Batches are only split by the driver, see FlightSqlStatement::Execute().
+    const bool split_batches = metadata_settings_.split_statement_batches_;
+    info_.SetProperty(SQL_BATCH_SUPPORT, static_cast<uint32_t>(
+        split_batches ? SQL_BS_SELECT_EXPLICIT | SQL_BS_ROW_COUNT_EXPLICIT : 0));
+    info_.SetProperty(SQL_BATCH_ROW_COUNT, static_cast<uint32_t>(split_batches ? SQL_BRC_EXPLICIT : 0));
+    info_.SetProperty(SQL_MULT_RESULT_SETS, split_batches ? "Y" : "N");
   } catch (...) {
     attribute_[CONNECTION_DEAD] = static_cast<uint32_t>(SQL_TRUE);
+    prepared_statement_cache_.reset();
+    query_canceller_.reset();
     sql_client_.reset();
+    flight_client_.reset();
 
     throw;
   }
@@ -218,7 +253,10 @@ void FlightSqlConnection::PopulateMetadataSettings(const Connection::ConnPropert
   metadata_settings_.use_wide_char_ = GetUseWideChar(conn_property_map);
   metadata_settings_.use_extended_flightsql_buffer_ = GetUseExtendedFlightSQLBuffer(conn_property_map);
   metadata_settings_.chunk_buffer_capacity_ = GetChunkBufferCapacity(conn_property_map);
+  metadata_settings_.spill_threshold_ = GetSpillThreshold(conn_property_map);
+  metadata_settings_.split_statement_batches_ = GetSplitStatementBatches(conn_property_map);
   metadata_settings_.hide_sql_tables_listing_ = GetHideSQLTablesListing(conn_property_map);
+  metadata_settings_.flatten_struct_columns_ = GetFlattenStructColumns(conn_property_map);
 }
 
 boost::optional<int32_t> FlightSqlConnection::GetStringColumnLength(const Connection::ConnPropertyMap &conn_property_map) {
@@ -266,11 +304,68 @@ size_t FlightSqlConnection::GetChunkBufferCapacity(const ConnPropertyMap &connPr
   return default_value;
 }
 
+size_t FlightSqlConnection::GetSpillThreshold(const ConnPropertyMap &connPropertyMap) {
+  // Spilling is off unless enabled.
+  size_t default_value = 0;
+  try {
+    size_t threshold_mb = AsInt32(0, connPropertyMap, FlightSqlConnection::SPILL_THRESHOLD_MB).value_or(default_value);
+    return threshold_mb * 1024 * 1024;
+  } catch (const std::exception& e) {
+    diagnostics_.AddWarning(
+            std::string("Invalid value for connection property " + FlightSqlConnection::SPILL_THRESHOLD_MB +
+                        ". Please ensure it has a valid numeric value. Message: " + e.what()),
+            "01000", odbcabstraction::ODBCErrorCodes_GENERAL_WARNING);
+  }
+
+  return default_value;
+}
+
+bool FlightSqlConnection::GetSplitStatementBatches(const ConnPropertyMap &connPropertyMap) {
+  // Off by default, as servers may run scripts themselves.
+  bool default_value = false;
+  return AsBool(connPropertyMap, FlightSqlConnection::SPLIT_STATEMENT_BATCHES).value_or(default_value);
+}
+
 bool FlightSqlConnection::GetHideSQLTablesListing(const ConnPropertyMap &connPropertyMap) {
   bool default_value = false;
   return AsBool(connPropertyMap, FlightSqlConnection::HIDE_SQL_TABLES_LISTING).value_or(default_value);
 }
 
+size_t FlightSqlConnection::GetPreparedStatementCacheSize(const ConnPropertyMap &connPropertyMap) {
+  size_t default_value = 16;
+  try {
+    return AsInt32(0, connPropertyMap, FlightSqlConnection::PREPARED_STATEMENT_CACHE_SIZE).value_or(default_value);
+  } catch (const std::exception& e) {
+    diagnostics_.AddWarning(
+            std::string("Invalid value for connection property " + FlightSqlConnection::PREPARED_STATEMENT_CACHE_SIZE +
+                        ". Please ensure it has a valid numeric value. Message: " + e.what()),
+            "01000", odbcabstraction::ODBCErrorCodes_GENERAL_WARNING);
+  }
+
+  return default_value;
+}
+
+size_t FlightSqlConnection::GetPreparedStatementPromotionThreshold(const ConnPropertyMap &connPropertyMap) {
+  size_t default_value = 0;
+  try {
+    return AsInt32(0, connPropertyMap, FlightSqlConnection::PREPARED_STATEMENT_PROMOTION_THRESHOLD)
+        .value_or(default_value);
+  } catch (const std::exception& e) {
+    diagnostics_.AddWarning(
+            std::string("Invalid value for connection property " +
+                        FlightSqlConnection::PREPARED_STATEMENT_PROMOTION_THRESHOLD +
+                        ". Please ensure it has a valid numeric value. Message: " + e.what()),
+            "01000", odbcabstraction::ODBCErrorCodes_GENERAL_WARNING);
+  }
+
+  return default_value;
+}
+
+bool FlightSqlConnection::GetFlattenStructColumns(const ConnPropertyMap &connPropertyMap) {
+  bool default_value = false;
+  return AsBool(connPropertyMap, FlightSqlConnection::FLATTEN_STRUCT_COLUMNS).value_or(default_value);
+}
+
 bool FlightSqlConnection::GetSendPingFrame(const ConnPropertyMap &connPropertyMap) {
   bool default_value = false;
   return AsBool(connPropertyMap, FlightSqlConnection::SEND_PING_FRAME).value_or(default_value);
@@ -449,7 +544,18 @@ void FlightSqlConnection::Close() {
     throw DriverException("Connection already closed.");
   }
 
+  // Cached handles are closed while the client is still available.
+  if (prepared_statement_cache_) {
+    prepared_statement_cache_->Clear();
+    prepared_statement_cache_.reset();
+  }
+  // Result sets may outlive the connection, but their cancel requests do not.
+  if (query_canceller_) {
+    query_canceller_->Close();
+    query_canceller_.reset();
+  }
   sql_client_.reset();
+  flight_client_.reset();
   closed_ = true;
   attribute_[CONNECTION_DEAD] = static_cast<uint32_t>(SQL_TRUE);
 }
@@ -459,6 +565,8 @@ std::shared_ptr<Statement> FlightSqlConnection::CreateStatement() {
       new FlightSqlStatement(
               diagnostics_,
               *sql_client_,
+              query_canceller_,
+              prepared_statement_cache_,
               call_options_,
               metadata_settings_
               )
@@ -12,7 +12,9 @@
 #include <arrow/flight/sql/api.h>
 #include <vector>
 
+#include "flight_sql_query_cancel.h"
 #include "get_info_cache.h"
+#include "prepared_statement_cache.h"
 #include "odbcabstraction/types.h"
 
 namespace driver {
@@ -35,7 +37,10 @@ private:
   std::map<AttributeId, Attribute> attribute_;
   arrow::flight::FlightClientOptions client_options_;
   arrow::flight::FlightCallOptions call_options_;
+  std::shared_ptr<arrow::flight::FlightClient> flight_client_;
   std::unique_ptr<arrow::flight::sql::FlightSqlClient> sql_client_;
+  std::shared_ptr<PreparedStatementCache> prepared_statement_cache_;
+  std::shared_ptr<QueryCanceller> query_canceller_;
   GetInfoCache info_;
   odbcabstraction::Diagnostics diagnostics_;
   odbcabstraction::OdbcVersion odbc_version_;
@@ -63,7 +68,12 @@ public:
   static const std::string USE_WIDE_CHAR;
   static const std::string USE_EXTENDED_FLIGHTSQL_BUFFER;
   static const std::string CHUNK_BUFFER_CAPACITY;
+  static const std::string SPILL_THRESHOLD_MB;
+  static const std::string SPLIT_STATEMENT_BATCHES;
   static const std::string HIDE_SQL_TABLES_LISTING;
+  static const std::string FLATTEN_STRUCT_COLUMNS;
+  static const std::string PREPARED_STATEMENT_CACHE_SIZE;
+  static const std::string PREPARED_STATEMENT_PROMOTION_THRESHOLD;
   static const std::string SEND_PING_FRAME;
   static const std::string PING_FRAME_INTERVAL_MS;
   static const std::string PING_FRAME_TIMEOUT_MS;
@@ -116,8 +126,18 @@ public:
 
   size_t GetChunkBufferCapacity(const ConnPropertyMap &connPropertyMap);
 
+  size_t GetSpillThreshold(const ConnPropertyMap &connPropertyMap);
+
+  bool GetSplitStatementBatches(const ConnPropertyMap &connPropertyMap);
+
   bool GetHideSQLTablesListing(const ConnPropertyMap &connPropertyMap);
 
+  bool GetFlattenStructColumns(const ConnPropertyMap &connPropertyMap);
+
+  size_t GetPreparedStatementCacheSize(const ConnPropertyMap &connPropertyMap);
+
+  size_t GetPreparedStatementPromotionThreshold(const ConnPropertyMap &connPropertyMap);
+
   static bool GetSendPingFrame(const ConnPropertyMap &connPropertyMap);
 
   static boost::optional<int> GetPingFrameIntervalMilliseconds(const ConnPropertyMap &connPropertyMap);
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "flight_sql_query_cancel.h"
+
+#include <arrow/buffer.h>
+#include <chrono>
+#include <memory>
+
+namespace driver {
+namespace flight_sql {
+
+using arrow::Status;
+using arrow::flight::Action;
+using arrow::flight::FlightCallOptions;
+using arrow::flight::FlightClient;
+using arrow::flight::FlightInfo;
+using arrow::flight::FlightStatusCode;
+using arrow::flight::FlightStatusDetail;
+using arrow::flight::ResultStream;
+using arrow::flight::TimeoutDuration;
+
+namespace {
+
+const char *const CANCEL_FLIGHT_INFO_ACTION = "CancelFlightInfo";
+const char *const CANCEL_QUERY_ACTION = "CancelQuery";
+const char *const CANCEL_QUERY_REQUEST_TYPE_URL =
+    "type.googleapis.com/arrow.flight.protocol.sql.ActionCancelQueryRequest";
+
+// Bounds how long a cancel request, fallback included, keeps its thread and
+// the client alive.
+const double CANCEL_TIMEOUT_SECONDS = 5;
+
+// The request messages only have length-delimited fields, which is simple
+// enough to encode here rather than depending on the generated protobuf code.
+void AppendLengthDelimitedField(std::string &out, uint32_t field_number,
+                                const std::string &value) {
+  out.push_back(static_cast<char>((field_number << 3) | 2));
+  uint64_t length = value.size();
+  while (length >= 0x80) {
+    out.push_back(static_cast<char>((length & 0x7F) | 0x80));
+    length >>= 7;
+  }
+  out.push_back(static_cast<char>(length));
+  out.append(value);
+}
+
+Status DoAction(FlightClient &client, const FlightCallOptions &call_options,
+                const std::string &type, const std::string &body) {
+  Action action;
+  action.type = type;
+  action.body = arrow::Buffer::FromString(body);
+
+  std::unique_ptr<ResultStream> results;
+  ARROW_RETURN_NOT_OK(client.DoAction(call_options, action, &results));
+
+  // The outcome is only known once the result stream is read.
+  std::unique_ptr<arrow::flight::Result> result;
+  do {
+    ARROW_RETURN_NOT_OK(results->Next(&result));
+  } while (result);
+  return Status::OK();
+}
+
+} // namespace
+
+std::string SerializeCancelFlightInfoRequest(const std::string &serialized_info) {
+  // message CancelFlightInfoRequest { FlightInfo info = 1; }
+  std::string request;
+  AppendLengthDelimitedField(request, 1, serialized_info);
+  return request;
+}
+
+std::string SerializeCancelQueryRequest(const std::string &serialized_info) {
+  // message ActionCancelQueryRequest { bytes info = 1; }
+  std::string request;
+  AppendLengthDelimitedField(request, 1, serialized_info);
+
+  // message Any { string type_url = 1; bytes value = 2; }
+  std::string any;
+  AppendLengthDelimitedField(any, 1, CANCEL_QUERY_REQUEST_TYPE_URL);
+  AppendLengthDelimitedField(any, 2, request);
+  return any;
+}
+
+bool ShouldFallBackToCancelQuery(const Status &status) {
+  if (status.ok() || status.IsCancelled()) {
+    return false;
+  }
+
+  // Deadlines and unreachable servers surface as IOError with a Flight detail.
+  const auto &flight_status = FlightStatusDetail::UnwrapStatus(status);
+  if (flight_status) {
+    switch (flight_status->code()) {
+      case FlightStatusCode::Cancelled:
+      case FlightStatusCode::TimedOut:
+      case FlightStatusCode::Unavailable:
+        return false;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+Status CancelQuery(FlightClient &client, FlightCallOptions call_options,
+                   const FlightInfo &flight_info) {
+  std::string serialized_info;
+  ARROW_RETURN_NOT_OK(flight_info.SerializeToString(&serialized_info));
+
+  if (call_options.timeout <= TimeoutDuration::zero() ||
+      call_options.timeout > TimeoutDuration{CANCEL_TIMEOUT_SECONDS}) {
+    call_options.timeout = TimeoutDuration{CANCEL_TIMEOUT_SECONDS};
+  }
+  const auto deadline = std::chrono::steady_clock::now() + call_options.timeout;
+
+  Status status = DoAction(client, call_options, CANCEL_FLIGHT_INFO_ACTION,
+                           SerializeCancelFlightInfoRequest(serialized_info));
+  if (!ShouldFallBackToCancelQuery(status)) {
+    return status;
+  }
+
+  // The fallback only gets what is left of the timeout.
+  call_options.timeout = std::chrono::duration_cast<TimeoutDuration>(
+      deadline - std::chrono::steady_clock::now());
+  if (call_options.timeout <= TimeoutDuration::zero()) {
+    return status;
+  }
+  return DoAction(client, call_options, CANCEL_QUERY_ACTION,
+                  SerializeCancelQueryRequest(serialized_info));
+}
+
+QueryCanceller::QueryCanceller(std::shared_ptr<FlightClient> client)
+    : client_(std::move(client)) {}
+
+QueryCanceller::~QueryCanceller() { Close(); }
+
+void QueryCanceller::JoinCompleted() {
+  for (auto it = requests_.begin(); it != requests_.end();) {
+    if (*it->done) {
+      it->thread.join();
+      it = requests_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void QueryCanceller::CancelInBackground(FlightCallOptions call_options,
+                                        std::shared_ptr<FlightInfo> flight_info) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!client_) {
+    return;
+  }
+  JoinCompleted();
+
+  Request request;
+  request.done = std::make_shared<std::atomic<bool>>(false);
+  std::shared_ptr<FlightClient> client = client_;
+  std::shared_ptr<std::atomic<bool>> done = request.done;
+  request.thread = std::thread([client, call_options, flight_info, done] {
+    ARROW_UNUSED(CancelQuery(*client, call_options, *flight_info));
+    *done = true;
+  });
+  requests_.push_back(std::move(request));
+}
+
+void QueryCanceller::Close() {
+  std::list<Request> requests;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    client_.reset();
+    requests.swap(requests_);
+  }
+
+  for (auto &request : requests) {
+    request.thread.join();
+  }
+}
+
+} // namespace flight_sql
+} // namespace driver
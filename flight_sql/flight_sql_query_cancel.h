@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#pragma once
+
+#include <arrow/flight/client.h>
+#include <arrow/flight/types.h>
+#include <arrow/status.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace driver {
+namespace flight_sql {
+
+/// \brief Asks the server to stop executing the query behind a FlightInfo.
+///
+/// Sends the Flight `CancelFlightInfo` action and, when the server does not
+/// handle it, the older Flight SQL `CancelQuery` action. Cancellation is best
+/// effort: the server may have finished already or not support either action.
+arrow::Status CancelQuery(arrow::flight::FlightClient &client,
+                          arrow::flight::FlightCallOptions call_options,
+                          const arrow::flight::FlightInfo &flight_info);
+
+/// \brief Tells whether CancelQuery() should retry with the `CancelQuery`
+/// action after `CancelFlightInfo` failed with the given status.
+///
+/// Servers that do not know an action reject it with various errors (older
+/// Arrow servers answer Invalid), so any failure falls back except those
+/// saying the request itself was cancelled, timed out or could not reach the
+/// server, where a second request would fail the same way.
+bool ShouldFallBackToCancelQuery(const arrow::Status &status);
+
+/// \brief Runs CancelQuery() on background threads for the result sets of a
+/// connection, so closing a statement never waits for the server.
+///
+/// Each request is bounded by its own timeout. Close() waits for the requests
+/// still running, so none of them outlives the connection or the driver.
+class QueryCanceller {
+private:
+  struct Request {
+    std::thread thread;
+    std::shared_ptr<std::atomic<bool>> done;
+  };
+
+  std::mutex mutex_;
+  std::shared_ptr<arrow::flight::FlightClient> client_;
+  std::list<Request> requests_;
+
+  /// \brief Joins the requests that completed. Called with mutex_ held.
+  void JoinCompleted();
+
+public:
+  explicit QueryCanceller(std::shared_ptr<arrow::flight::FlightClient> client);
+
+  ~QueryCanceller();
+
+  /// \brief Starts CancelQuery() for the given FlightInfo. Does nothing once
+  /// the canceller is closed.
+  void CancelInBackground(arrow::flight::FlightCallOptions call_options,
+                          std::shared_ptr<arrow::flight::FlightInfo> flight_info);
+
+  /// \brief Waits for the requests still running and releases the client.
+  void Close();
+};
+
+/// \brief Serializes a CancelFlightInfoRequest holding the given serialized
+/// FlightInfo.
+std::string SerializeCancelFlightInfoRequest(const std::string &serialized_info);
+
+/// \brief Serializes an ActionCancelQueryRequest holding the given serialized
+/// FlightInfo, packed in a google.protobuf.Any as Flight SQL actions expect.
+std::string SerializeCancelQueryRequest(const std::string &serialized_info);
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "flight_sql_query_cancel.h"
+
+#include <arrow/flight/types.h>
+
+#include "gtest/gtest.h"
+
+namespace driver {
+namespace flight_sql {
+
+TEST(QueryCancel, SerializeCancelFlightInfoRequest) {
+  ASSERT_EQ(std::string("\x0a\x03" "abc", 5), SerializeCancelFlightInfoRequest("abc"));
+}
+
+TEST(QueryCancel, SerializeCancelFlightInfoRequestWithLongInfo) {
+  const std::string info(300, 'x');
+  // 300 takes two bytes as a varint.
+  ASSERT_EQ(std::string("\x0a\xac\x02", 3) + info, SerializeCancelFlightInfoRequest(info));
+}
+
+TEST(QueryCancel, SerializeCancelQueryRequest) {
+  const std::string type_url = "type.googleapis.com/arrow.flight.protocol.sql.ActionCancelQueryRequest";
+  const std::string expected = std::string("\x0a") + static_cast<char>(type_url.size()) + type_url +
+                               std::string("\x12\x05\x0a\x03" "abc", 7);
+
+  ASSERT_EQ(expected, SerializeCancelQueryRequest("abc"));
+}
+
+TEST(QueryCancel, FallBackWhenCancelFlightInfoIsRejected) {
+  ASSERT_TRUE(ShouldFallBackToCancelQuery(arrow::Status::NotImplemented("unknown action")));
+  // Older Arrow servers reject unknown actions as invalid.
+  ASSERT_TRUE(ShouldFallBackToCancelQuery(arrow::Status::Invalid("unknown action")));
+  ASSERT_TRUE(ShouldFallBackToCancelQuery(arrow::Status::KeyError("unknown action")));
+  ASSERT_TRUE(ShouldFallBackToCancelQuery(
+      arrow::flight::MakeFlightError(arrow::flight::FlightStatusCode::Internal, "unknown action")));
+}
+
+TEST(QueryCancel, NoFallBackWhenCancelFlightInfoCannotComplete) {
+  ASSERT_FALSE(ShouldFallBackToCancelQuery(arrow::Status::OK()));
+  ASSERT_FALSE(ShouldFallBackToCancelQuery(arrow::Status::Cancelled("cancelled")));
+  ASSERT_FALSE(ShouldFallBackToCancelQuery(
+      arrow::flight::MakeFlightError(arrow::flight::FlightStatusCode::Cancelled, "cancelled")));
+  ASSERT_FALSE(ShouldFallBackToCancelQuery(
+      arrow::flight::MakeFlightError(arrow::flight::FlightStatusCode::TimedOut, "deadline exceeded")));
+  ASSERT_FALSE(ShouldFallBackToCancelQuery(
+      arrow::flight::MakeFlightError(arrow::flight::FlightStatusCode::Unavailable, "unavailable")));
+}
+
+} // namespace flight_sql
+} // namespace driver
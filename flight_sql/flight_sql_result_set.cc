@@ -7,12 +7,16 @@
 #include "flight_sql_result_set.h"
 #include <odbcabstraction/platform.h>
 
+#include <arrow/c/bridge.h>
 #include <arrow/flight/types.h>
+#include <arrow/record_batch.h>
 #include <arrow/scalar.h>
 #include <utility>
 
+#include "flight_sql_query_cancel.h"
 #include "flight_sql_result_set_column.h"
 #include "flight_sql_result_set_metadata.h"
+#include "result_set_batch_reader.h"
 #include "utils.h"
 #include "odbcabstraction/types.h"
 
@@ -35,23 +39,34 @@ FlightSqlResultSet::FlightSqlResultSet(
     const std::shared_ptr<FlightInfo> &flight_info,
     const std::shared_ptr<RecordBatchTransformer> &transformer,
     odbcabstraction::Diagnostics& diagnostics,
-    const odbcabstraction::MetadataSettings &metadata_settings)
+    const odbcabstraction::MetadataSettings &metadata_settings,
+    size_t max_length,
+    std::shared_ptr<QueryCanceller> query_canceller,
+    bool scrollable)
     :
       metadata_settings_(metadata_settings),
-      chunk_buffer_(
+      chunk_buffer_(std::make_shared<FlightStreamChunkBuffer>(
         flight_sql_client,
         call_options,
         flight_info,
         metadata_settings_.chunk_buffer_capacity_,
-        metadata_settings_.use_extended_flightsql_buffer_),
+        metadata_settings_.use_extended_flightsql_buffer_,
+        metadata_settings_.spill_threshold_)),
+      query_canceller_(std::move(query_canceller)),
+      call_options_(call_options),
+      flight_info_(flight_info),
+      server_cancel_requested_(false),
       transformer_(transformer),
       metadata_(transformer ? new FlightSqlResultSetMetadata(transformer->GetTransformedSchema(),
                                                              metadata_settings_)
                             : new FlightSqlResultSetMetadata(flight_info, metadata_settings_)),
+      current_batch_(0),
       columns_(metadata_->GetColumnCount()),
       get_data_offsets_(metadata_->GetColumnCount(), 0),
       diagnostics_(diagnostics),
-      current_row_(0), num_binding_(0), reset_get_data_(false) {
+      current_row_(0), num_binding_(0), reset_get_data_(false), exported_(false),
+      export_closed_(std::make_shared<std::atomic<bool>>(false)),
+      max_length_(max_length) {
   current_chunk_.data = nullptr;
   if (transformer_) {
     schema_ = transformer_->GetTransformedSchema();
@@ -59,6 +74,10 @@ FlightSqlResultSet::FlightSqlResultSet(
     ThrowIfNotOK(flight_info->GetSchema(nullptr, &schema_));
   }
 
+  if (scrollable) {
+    spool_ = RecordBatchSpool::Make(schema_);
+  }
+
   for (size_t i = 0; i < columns_.size(); ++i) {
     columns_[i] = FlightSqlResultSetColumn(metadata_settings.use_wide_char_);
   }
@@ -68,20 +87,24 @@ size_t FlightSqlResultSet::Move(size_t rows, size_t bind_offset, size_t bind_typ
   // Consider it might be the first call to Move() and current_chunk is not
   // populated yet
   assert(rows > 0);
-  if (current_chunk_.data == nullptr) {
-    if (!chunk_buffer_.GetNext(&current_chunk_)) {
-      return 0;
-    }
-
-    if (transformer_) {
-      current_chunk_.data = transformer_->Transform(current_chunk_.data);
+  // The remaining rows were handed over to an exported stream.
+  if (exported_) {
+    if (row_status_array) {
+      std::fill(row_status_array, &row_status_array[rows], odbcabstraction::RowStatus_NOROW);
     }
+    return 0;
+  }
 
-    for (size_t column_num = 0; column_num < columns_.size(); ++column_num) {
-      columns_[column_num].ResetAccessor(current_chunk_.data->column(column_num));
+  if (current_chunk_.data == nullptr) {
+    if (!GetNextBatch()) {
+      return 0;
     }
+    UseCurrentBatch();
   }
 
+  // Values returned as STRING_VIEW by the previous fetch are no longer valid.
+  retained_arrays_.clear();
+
   // Reset GetData value offsets.
   if (num_binding_ != get_data_offsets_.size() && reset_get_data_) {
     std::fill(get_data_offsets_.begin(), get_data_offsets_.end(), 0);
@@ -95,17 +118,18 @@ size_t FlightSqlResultSet::Move(size_t rows, size_t bind_offset, size_t bind_typ
                  static_cast<size_t>(batch_rows - current_row_));
 
     if (rows_to_fetch == 0) {
-      if (!chunk_buffer_.GetNext(&current_chunk_)) {
-        break;
-      }
-
-      if (transformer_) {
-        current_chunk_.data = transformer_->Transform(current_chunk_.data);
+      // Rows already fetched may point into the batch being replaced.
+      for (const auto &column : columns_) {
+        if (column.is_bound_ && column.binding_.target_type == odbcabstraction::CDataType_STRING_VIEW &&
+            column.GetBindingArray()) {
+          retained_arrays_.push_back(column.GetBindingArray());
+        }
       }
 
-      for (size_t column_num = 0; column_num < columns_.size(); ++column_num) {
-        columns_[column_num].ResetAccessor(current_chunk_.data->column(column_num));
+      if (!GetNextBatch()) {
+        break;
       }
+      UseCurrentBatch();
       current_row_ = 0;
       continue;
     }
@@ -115,7 +139,8 @@ size_t FlightSqlResultSet::Move(size_t rows, size_t bind_offset, size_t bind_typ
       if (!column.is_bound_)
         continue;
 
-      auto *accessor = column.GetAccessorForBinding();
+      int64_t accessor_row;
+      auto *accessor = column.GetAccessorForBinding(current_row_, static_cast<int64_t>(rows_to_fetch), accessor_row);
       ColumnBinding shifted_binding = column.binding_;
       uint16_t *shifted_row_status_array = row_status_array ? &row_status_array[fetched_rows] : nullptr;
 
@@ -142,7 +167,7 @@ size_t FlightSqlResultSet::Move(size_t rows, size_t bind_offset, size_t bind_typ
           }
 
           int64_t value_offset = 0;
-          accessor_rows = accessor->GetColumnarData(&shifted_binding, current_row_, rows_to_fetch, value_offset, false,
+          accessor_rows = accessor->GetColumnarData(&shifted_binding, accessor_row, rows_to_fetch, value_offset, false,
                                                     diagnostics_, shifted_row_status_array);
         }
         else {
@@ -166,7 +191,7 @@ size_t FlightSqlResultSet::Move(size_t rows, size_t bind_offset, size_t bind_typ
 
             // Adjust offsets passed to the accessor as we fetch rows.
             // Note that current_row_ is updated outside of this loop.
-            accessor_rows += accessor->GetColumnarData(&shifted_binding, current_row_ + i, 1, value_offset, false,
+            accessor_rows += accessor->GetColumnarData(&shifted_binding, accessor_row + i, 1, value_offset, false,
                                                        diagnostics_, shifted_row_status_array);
             if (shifted_binding.buffer) {
               shifted_binding.buffer =
@@ -208,14 +233,176 @@ size_t FlightSqlResultSet::Move(size_t rows, size_t bind_offset, size_t bind_typ
   return fetched_rows;
 }
 
+size_t FlightSqlResultSet::Skip(size_t rows, uint16_t *row_status_array) {
+  assert(rows > 0);
+  if (exported_) {
+    if (row_status_array) {
+      std::fill(row_status_array, &row_status_array[rows], odbcabstraction::RowStatus_NOROW);
+    }
+    return 0;
+  }
+
+  // Only row counts are looked at, so batches are neither transformed nor
+  // handed to the columns until one is actually positioned on.
+  bool batch_changed = false;
+  if (current_chunk_.data == nullptr) {
+    if (!GetNextBatch()) {
+      return 0;
+    }
+    batch_changed = true;
+  }
+
+  retained_arrays_.clear();
+
+  size_t skipped_rows = 0;
+  while (skipped_rows < rows) {
+    size_t batch_rows = current_chunk_.data->num_rows();
+    size_t rows_to_skip =
+        std::min(static_cast<size_t>(rows - skipped_rows),
+                 static_cast<size_t>(batch_rows - current_row_));
+
+    if (rows_to_skip == 0) {
+      if (!GetNextBatch()) {
+        break;
+      }
+      batch_changed = true;
+      current_row_ = 0;
+      continue;
+    }
+
+    current_row_ += static_cast<int64_t>(rows_to_skip);
+    skipped_rows += rows_to_skip;
+  }
+
+  if (batch_changed) {
+    UseCurrentBatch();
+  }
+
+  // The row GetData reads from has moved.
+  std::fill(get_data_offsets_.begin(), get_data_offsets_.end(), 0);
+
+  if (row_status_array) {
+    std::fill(row_status_array, &row_status_array[skipped_rows], odbcabstraction::RowStatus_SUCCESS);
+    std::fill(&row_status_array[skipped_rows], &row_status_array[rows], odbcabstraction::RowStatus_NOROW);
+  }
+  return skipped_rows;
+}
+
+bool FlightSqlResultSet::Seek(size_t row) {
+  if (!spool_) {
+    throw DriverException("The cursor is forward-only", "HY106");
+  }
+
+  // Batches up to the row are read from the server first.
+  const int64_t target_row = static_cast<int64_t>(row);
+  while (spool_->num_rows() <= target_row) {
+    if (!SpoolNextBatch(nullptr)) {
+      return false;
+    }
+  }
+
+  const size_t batch = spool_->FindBatch(target_row);
+  if (current_chunk_.data == nullptr || batch != current_batch_) {
+    current_chunk_.data = spool_->ReadBatch(batch);
+    current_batch_ = batch;
+    UseCurrentBatch();
+  }
+  current_row_ = target_row - spool_->GetBatchOffset(batch);
+
+  // The row GetData reads from has moved.
+  std::fill(get_data_offsets_.begin(), get_data_offsets_.end(), 0);
+  return true;
+}
+
+size_t FlightSqlResultSet::CountRows() {
+  if (!spool_) {
+    throw DriverException("The cursor is forward-only", "HY106");
+  }
+
+  while (SpoolNextBatch(nullptr)) {
+    // The rest of the result is written to the spool.
+  }
+  return static_cast<size_t>(spool_->num_rows());
+}
+
+bool FlightSqlResultSet::GetNextBatch() {
+  if (!spool_) {
+    return chunk_buffer_->GetNext(&current_chunk_);
+  }
+
+  // Batches before the end of the spool were already received.
+  const size_t next_batch = current_chunk_.data ? current_batch_ + 1 : 0;
+  std::shared_ptr<RecordBatch> batch;
+  if (next_batch < spool_->num_batches()) {
+    batch = spool_->ReadBatch(next_batch);
+  } else if (!SpoolNextBatch(&batch)) {
+    return false;
+  }
+
+  current_chunk_.data = std::move(batch);
+  current_batch_ = next_batch;
+  return true;
+}
+
+bool FlightSqlResultSet::SpoolNextBatch(std::shared_ptr<RecordBatch> *batch) {
+  FlightStreamChunk chunk;
+  if (!chunk_buffer_->GetNext(&chunk)) {
+    return false;
+  }
+
+  std::shared_ptr<RecordBatch> data = transformer_ ? transformer_->Transform(chunk.data) : chunk.data;
+  spool_->Append(*data);
+  if (batch) {
+    *batch = std::move(data);
+  }
+  return true;
+}
+
+void FlightSqlResultSet::UseCurrentBatch() {
+  // Spooled batches were transformed before they were written.
+  if (transformer_ && !spool_) {
+    current_chunk_.data = transformer_->Transform(current_chunk_.data);
+  }
+
+  for (size_t column_num = 0; column_num < columns_.size(); ++column_num) {
+    columns_[column_num].ResetAccessor(current_chunk_.data->column(column_num));
+  }
+}
+
+void FlightSqlResultSet::CancelOnServer() {
+  if (!query_canceller_ || chunk_buffer_->IsExhausted() || server_cancel_requested_.exchange(true)) {
+    return;
+  }
+
+  // Best effort: servers without cancellation support finish the query on
+  // their own, and the results are discarded either way. Nothing waits for
+  // the server, as this runs when cursors are closed.
+  query_canceller_->CancelInBackground(call_options_, flight_info_);
+}
+
+void FlightSqlResultSet::MarkExportClosed() {
+  // Set before the chunk buffer is closed, so the reader sees it once the
+  // buffer stops returning batches.
+  if (!chunk_buffer_->IsExhausted()) {
+    *export_closed_ = true;
+  }
+}
+
 void FlightSqlResultSet::Close() {
-  chunk_buffer_.Close();
+  CancelOnServer();
+  MarkExportClosed();
+  chunk_buffer_->Close();
   current_chunk_.data = nullptr;
+  retained_arrays_.clear();
+  spool_.reset();
 }
 
 void FlightSqlResultSet::Cancel() {
-  chunk_buffer_.Close();
-  current_chunk_.data = nullptr;
+  // May run on another thread while rows are fetched, so only thread-safe
+  // state is touched here.
+  CancelOnServer();
+  MarkExportClosed();
+  chunk_buffer_->Close();
 }
 
 bool FlightSqlResultSet::GetData(int column_n, int16_t target_type,
@@ -229,21 +416,58 @@ bool FlightSqlResultSet::GetData(int column_n, int16_t target_type,
   }
   
   ColumnBinding binding(ConvertCDataTypeFromV2ToV3(target_type), precision, scale, buffer, buffer_length,
-                        strlen_buffer);
+                        strlen_buffer, max_length_);
 
   auto &column = columns_[column_n - 1];
-  Accessor *accessor = column.GetAccessorForGetData(binding.target_type);
-
 
   // Note: current_row_ is always positioned at the index _after_ the one we are
   // on after calling Move(). So if we want to get data from the _last_ row
   // fetched, we need to subtract one from the current row.
-  accessor->GetColumnarData(&binding, current_row_ - 1, 1, value_offset, true, diagnostics_, nullptr);
+  int64_t accessor_row;
+  Accessor *accessor = column.GetAccessorForGetData(binding.target_type, current_row_ - 1, accessor_row);
+
+  accessor->GetColumnarData(&binding, accessor_row, 1, value_offset, true, diagnostics_, nullptr);
 
   // If there was truncation, the converter would have reported it to the diagnostics.
   return diagnostics_.HasWarning();
 }
 
+void FlightSqlResultSet::ExportArrowStream(struct ArrowArrayStream *out,
+                                           boost::optional<size_t> max_rows) {
+  if (exported_) {
+    throw DriverException("The result set was already exported", "HY010");
+  }
+  if (spool_) {
+    throw DriverException("Scrollable result sets cannot be exported", "HYC00");
+  }
+
+  // Rows of the current batch not fetched yet come first.
+  std::shared_ptr<RecordBatch> first_batch;
+  if (current_chunk_.data && current_row_ < current_chunk_.data->num_rows()) {
+    first_batch = current_chunk_.data->Slice(current_row_);
+  }
+
+  std::shared_ptr<FlightStreamChunkBuffer> chunk_buffer = chunk_buffer_;
+  std::shared_ptr<RecordBatchTransformer> transformer = transformer_;
+  ResultSetBatchReader::Supplier supplier = [chunk_buffer, transformer](std::shared_ptr<RecordBatch> *batch) -> bool {
+    FlightStreamChunk chunk;
+    if (!chunk_buffer->GetNext(&chunk)) {
+      return false;
+    }
+    *batch = transformer ? transformer->Transform(chunk.data) : chunk.data;
+    return true;
+  };
+
+  boost::optional<int64_t> remaining_rows;
+  if (max_rows) {
+    remaining_rows = static_cast<int64_t>(*max_rows);
+  }
+  auto reader = std::make_shared<ResultSetBatchReader>(
+      schema_, std::move(supplier), std::move(first_batch), export_closed_, remaining_rows);
+  ThrowIfNotOK(arrow::ExportRecordBatchReader(reader, out));
+  exported_ = true;
+}
+
 std::shared_ptr<ResultSetMetadata> FlightSqlResultSet::GetMetadata() {
   return metadata_;
 }
@@ -266,7 +490,7 @@ void FlightSqlResultSet::BindColumn(int column_n, int16_t target_type,
   }
 
   ColumnBinding binding(ConvertCDataTypeFromV2ToV3(target_type), precision, scale, buffer, buffer_length,
-                        strlen_buffer);
+                        strlen_buffer, max_length_);
   column.SetBinding(binding, schema_->field(column_n - 1)->type()->id());
 }
 
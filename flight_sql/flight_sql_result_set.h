@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include "flight_sql_query_cancel.h"
 #include "flight_sql_stream_chunk_buffer.h"
+#include "record_batch_spool.h"
 #include "record_batch_transformer.h"
 #include "utils.h"
 #include "odbcabstraction/types.h"
@@ -17,6 +19,8 @@
 #include <odbcabstraction/spi/result_set.h>
 #include <odbcabstraction/diagnostics.h>
 
+#include <atomic>
+
 namespace driver {
 namespace flight_sql {
 
@@ -36,17 +40,53 @@ class FlightSqlResultSetColumn;
 class FlightSqlResultSet : public ResultSet {
 private:
   const odbcabstraction::MetadataSettings& metadata_settings_;
-  FlightStreamChunkBuffer chunk_buffer_;
+  std::shared_ptr<FlightStreamChunkBuffer> chunk_buffer_;
+  // Used to cancel the query on the server when the result set is abandoned.
+  // Null for results that are not backed by a server-side query.
+  std::shared_ptr<QueryCanceller> query_canceller_;
+  arrow::flight::FlightCallOptions call_options_;
+  std::shared_ptr<FlightInfo> flight_info_;
+  std::atomic<bool> server_cancel_requested_;
   FlightStreamChunk current_chunk_;
   std::shared_ptr<Schema> schema_;
   std::shared_ptr<RecordBatchTransformer> transformer_;
   std::shared_ptr<ResultSetMetadata> metadata_;
+  // Holds every batch received when the result set is scrollable, with
+  // current_batch_ being the index of current_chunk_ in it.
+  std::unique_ptr<RecordBatchSpool> spool_;
+  size_t current_batch_;
   std::vector<FlightSqlResultSetColumn> columns_;
   std::vector<int64_t> get_data_offsets_;
+  // Arrays of earlier batches referenced by STRING_VIEW bindings during the
+  // current fetch, kept alive until the next one.
+  std::vector<std::shared_ptr<arrow::Array>> retained_arrays_;
   odbcabstraction::Diagnostics &diagnostics_;
   int64_t current_row_;
   int num_binding_;
   bool reset_get_data_;
+  bool exported_;
+  // Shared with the exported stream, which fails once this is set.
+  std::shared_ptr<std::atomic<bool>> export_closed_;
+  size_t max_length_;
+
+  /// \brief Cancels the query on the server if its results were not read to
+  /// the end.
+  void CancelOnServer();
+
+  /// \brief Makes an exported stream fail if the result was not read to the
+  /// end, rather than end with rows missing.
+  void MarkExportClosed();
+
+  /// \brief Makes the batch after the current one current. Returns false at
+  /// the end of the result.
+  bool GetNextBatch();
+
+  /// \brief Reads the next batch from the server into the spool. Returns
+  /// false at the end of the result.
+  bool SpoolNextBatch(std::shared_ptr<arrow::RecordBatch> *batch);
+
+  /// \brief Has the columns read from a new current batch.
+  void UseCurrentBatch();
 
 public:
   ~FlightSqlResultSet() override;
@@ -57,7 +97,10 @@ public:
       const std::shared_ptr<FlightInfo> &flight_info,
       const std::shared_ptr<RecordBatchTransformer> &transformer,
       odbcabstraction::Diagnostics& diagnostics,
-      const odbcabstraction::MetadataSettings &metadata_settings);
+      const odbcabstraction::MetadataSettings &metadata_settings,
+      size_t max_length = 0,
+      std::shared_ptr<QueryCanceller> query_canceller = nullptr,
+      bool scrollable = false);
 
   void Close() override;
 
@@ -69,11 +112,20 @@ public:
 
   size_t Move(size_t rows, size_t bind_offset, size_t bind_type, uint16_t *row_status_array) override;
 
+  size_t Skip(size_t rows, uint16_t *row_status_array) override;
+
+  bool Seek(size_t row) override;
+
+  size_t CountRows() override;
+
   std::shared_ptr<ResultSetMetadata> GetMetadata() override;
 
   void BindColumn(int column_n, int16_t target_type, int precision, int scale,
                   void *buffer, size_t buffer_length,
                   ssize_t *strlen_buffer) override;
+
+  void ExportArrowStream(struct ArrowArrayStream *out,
+                         boost::optional<size_t> max_rows) override;
 };
 
 } // namespace flight_sql
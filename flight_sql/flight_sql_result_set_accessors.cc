@@ -28,6 +28,10 @@ const std::unordered_map<SourceAndTargetPair, AccessorConstructor,
          }},
         {SourceAndTargetPair(arrow::Type::type::STRING, CDataType_WCHAR),
                 CreateWCharStringArrayAccessor},
+        {SourceAndTargetPair(arrow::Type::type::STRING, CDataType_STRING_VIEW),
+         [](arrow::Array *array) {
+           return new StringViewArrayFlightSqlAccessor<StringArray>(array);
+         }},
         {SourceAndTargetPair(arrow::Type::type::DOUBLE, CDataType_DOUBLE),
          [](arrow::Array *array) {
            return new PrimitiveArrayFlightSqlAccessor<DoubleArray,
@@ -88,6 +92,16 @@ const std::unordered_map<SourceAndTargetPair, AccessorConstructor,
          [](arrow::Array *array) {
            return new BinaryArrayFlightSqlAccessor<CDataType_BINARY>(array);
          }},
+        {SourceAndTargetPair(arrow::Type::type::BINARY, CDataType_CHAR),
+         [](arrow::Array *array) {
+           return new HexBinaryArrayFlightSqlAccessor<CDataType_CHAR, char>(array);
+         }},
+        {SourceAndTargetPair(arrow::Type::type::BINARY, CDataType_WCHAR),
+                CreateWCharHexBinaryArrayAccessor},
+        {SourceAndTargetPair(arrow::Type::type::BINARY, CDataType_STRING_VIEW),
+         [](arrow::Array *array) {
+           return new StringViewArrayFlightSqlAccessor<BinaryArray>(array);
+         }},
         {SourceAndTargetPair(arrow::Type::type::DATE32, CDataType_DATE),
           [](arrow::Array *array) {
             return new DateArrayFlightSqlAccessor<CDataType_DATE, Date32Array>(array);
@@ -9,6 +9,7 @@
 #include "flight_sql_result_set_accessors.h"
 #include "utils.h"
 #include <accessors/types.h>
+#include <algorithm>
 #include <memory>
 #include <odbcabstraction/types.h>
 
@@ -16,6 +17,10 @@ namespace driver {
 namespace flight_sql {
 
 namespace {
+// Minimum number of rows converted at once, so reading a batch one row at a
+// time, through GetData or a rowset of one, doesn't run a conversion per row.
+constexpr int64_t MIN_CONVERSION_WINDOW = 64;
+
 std::shared_ptr<Array>
 CastArray(const std::shared_ptr<arrow::Array> &original_array,
           CDataType target_type) {
@@ -30,22 +35,51 @@ CastArray(const std::shared_ptr<arrow::Array> &original_array,
 }
 } // namespace
 
-std::unique_ptr<Accessor>
-FlightSqlResultSetColumn::CreateAccessor(CDataType target_type) {
-  cached_casted_array_ = CastArray(original_array_, target_type);
+Accessor *
+FlightSqlResultSetColumn::GetWindowAccessor(ConvertedWindow &window,
+                                            CDataType target_type, int64_t row,
+                                            int64_t cells,
+                                            int64_t &accessor_row) {
+  if (!window.Covers(target_type, row, cells)) {
+    window.accessor.reset();
+    if (NeedArrayConversion(original_array_->type_id(), target_type)) {
+      const int64_t length = std::min(std::max(cells, MIN_CONVERSION_WINDOW),
+                                      original_array_->length() - row);
+      window.array = CastArray(original_array_->Slice(row, length), target_type);
+      window.start = row;
+    } else {
+      // No conversion, so the accessor can read the whole batch in place.
+      window.array = original_array_;
+      window.start = 0;
+    }
+    window.accessor = flight_sql::CreateAccessor(window.array.get(), target_type);
+  }
 
-  return flight_sql::CreateAccessor(cached_casted_array_.get(), target_type);
+  accessor_row = row - window.start;
+  return window.accessor.get();
 }
 
 Accessor *
-FlightSqlResultSetColumn::GetAccessorForTargetType(CDataType target_type) {
-  // Cast the original array to a type matching the target_type.
+FlightSqlResultSetColumn::GetAccessorForBinding(int64_t row, int64_t cells,
+                                                int64_t &accessor_row) {
+  return GetWindowAccessor(binding_window_, binding_.target_type, row, cells,
+                           accessor_row);
+}
+
+Accessor *
+FlightSqlResultSetColumn::GetAccessorForGetData(CDataType target_type, int64_t row,
+                                                int64_t &accessor_row) {
   if (target_type == odbcabstraction::CDataType_DEFAULT) {
     target_type = ConvertArrowTypeToC(original_array_->type_id(), use_wide_char_);
   }
 
-  cached_accessor_ = CreateAccessor(target_type);
-  return cached_accessor_.get();
+  // Reuse the rows converted for the binding, if they hold this one.
+  if (binding_window_.Covers(target_type, row, 1)) {
+    accessor_row = row - binding_window_.start;
+    return binding_window_.accessor.get();
+  }
+
+  return GetWindowAccessor(get_data_window_, target_type, row, 1, accessor_row);
 }
 
 FlightSqlResultSetColumn::FlightSqlResultSetColumn(bool use_wide_char)
@@ -67,16 +101,13 @@ void FlightSqlResultSetColumn::SetBinding(const ColumnBinding& new_binding, arro
     binding_.precision = arrow::Decimal128Type::kMaxPrecision;
   }
 
-  // Rebuild the accessor and casted array if the target type changed.
-  if (original_array_ && (!cached_casted_array_ || cached_accessor_->target_type_ != binding_.target_type)) {
-    cached_accessor_ = CreateAccessor(binding_.target_type);
-  }
+  // The accessor is rebuilt with the binding's new parameters on the next fetch.
+  binding_window_.Reset();
 }
 
 void FlightSqlResultSetColumn::ResetBinding() {
   is_bound_ = false;
-  cached_casted_array_.reset();
-  cached_accessor_.reset();
+  binding_window_.Reset();
 }
 
 } // namespace flight_sql
@@ -15,15 +15,40 @@ namespace flight_sql {
 
 using arrow::Array;
 
+/// \brief Rows of the original array converted to a C type, along with the
+/// accessor reading them.
+struct ConvertedWindow {
+  std::shared_ptr<Array> array;
+  std::unique_ptr<Accessor> accessor;
+  /// Row of the original array the converted array starts at.
+  int64_t start = 0;
+
+  inline void Reset() {
+    array.reset();
+    accessor.reset();
+    start = 0;
+  }
+
+  inline bool Covers(CDataType target_type, int64_t row, int64_t cells) const {
+    return accessor && accessor->target_type_ == target_type &&
+           row >= start && row + cells <= start + array->length();
+  }
+};
+
 class FlightSqlResultSetColumn {
 private:
   std::shared_ptr<Array> original_array_;
-  std::shared_ptr<Array> cached_casted_array_;
-  std::unique_ptr<Accessor> cached_accessor_;
 
-  std::unique_ptr<Accessor> CreateAccessor(CDataType target_type);
+  // Conversions are done on slices of the batch holding the rows being read
+  // rather than on the whole batch, which may be much larger than what the
+  // application ends up fetching. Bound columns and GetData keep separate
+  // windows so they don't evict each other.
+  ConvertedWindow binding_window_;
+  ConvertedWindow get_data_window_;
 
-  Accessor *GetAccessorForTargetType(CDataType target_type);
+  Accessor *GetWindowAccessor(ConvertedWindow &window, CDataType target_type,
+                              int64_t row, int64_t cells,
+                              int64_t &accessor_row);
 
 public:
   FlightSqlResultSetColumn() = default;
@@ -33,36 +58,37 @@ public:
   bool use_wide_char_;
   bool is_bound_;
 
-  inline Accessor *GetAccessorForBinding() {
-    return cached_accessor_.get();
-  }
-
-  inline Accessor *GetAccessorForGetData(CDataType target_type) {
-    if (target_type == odbcabstraction::CDataType_DEFAULT) {
-      target_type = ConvertArrowTypeToC(original_array_->type_id(), use_wide_char_);
-    }
+  /// \brief Returns an accessor able to read the given rows into the binding.
+  /// \param row           The first row of the current batch to be read.
+  /// \param cells         The number of rows to be read.
+  /// \param accessor_row  Receives the row to pass to the returned accessor.
+  /// \return the accessor.
+  Accessor *GetAccessorForBinding(int64_t row, int64_t cells,
+                                  int64_t &accessor_row);
 
-    if (cached_accessor_ && cached_accessor_->target_type_ == target_type) {
-      return cached_accessor_.get();
-    }
-    return GetAccessorForTargetType(target_type);
+  /// \brief Returns the array the binding's accessor currently reads from.
+  inline const std::shared_ptr<Array> &GetBindingArray() const {
+    return binding_window_.array;
   }
 
+  /// \brief Returns an accessor able to read the given row as target_type.
+  /// \param target_type   The C type to convert the value to.
+  /// \param row           The row of the current batch to be read.
+  /// \param accessor_row  Receives the row to pass to the returned accessor.
+  /// \return the accessor.
+  Accessor *GetAccessorForGetData(CDataType target_type, int64_t row,
+                                  int64_t &accessor_row);
+
   void SetBinding(const ColumnBinding& new_binding, arrow::Type::type arrow_type);
 
   void ResetBinding();
 
   inline void ResetAccessor(std::shared_ptr<Array> array) {
     original_array_ = std::move(array);
-    if (cached_accessor_) {
-      cached_accessor_ = CreateAccessor(cached_accessor_->target_type_);
-    } else if (is_bound_) {
-      cached_accessor_ = CreateAccessor(binding_.target_type);
-    } else {
-      cached_casted_array_.reset();
-      cached_accessor_.reset();
-    }
+    binding_window_.Reset();
+    get_data_window_.Reset();
   }
 };
+
 } // namespace flight_sql
 } // namespace driver
@@ -11,13 +11,17 @@
 #include "flight_sql_statement_get_columns.h"
 #include "flight_sql_statement_get_tables.h"
 #include "flight_sql_statement_get_type_info.h"
+#include "parameter_batch_builder.h"
 #include "record_batch_transformer.h"
 #include "utils.h"
 #include <arrow/io/memory.h>
 #include <sql.h>
 #include <sqlext.h>
 
+#include <algorithm>
 #include <boost/optional.hpp>
+#include <chrono>
+#include <future>
 #include <utility>
 #include <odbcabstraction/exceptions.h>
 
@@ -40,13 +44,54 @@ using driver::odbcabstraction::Statement;
 
 namespace {
 
-void ClosePreparedStatementIfAny(
-    std::shared_ptr<arrow::flight::sql::PreparedStatement>
-        &prepared_statement) {
-  if (prepared_statement != nullptr) {
-    ThrowIfNotOK(prepared_statement->Close());
-    prepared_statement.reset();
+/// Handles keep the call options they were prepared with, so they are only
+/// shared between statements using the same options.
+std::string GetPreparedStatementKey(const std::string &query,
+                                    const FlightCallOptions &call_options) {
+  std::string key = query;
+  for (const auto &header : call_options.headers) {
+    key += '\0';
+    key += header.first;
+    key += '=';
+    key += header.second;
+  }
+  key += '\0';
+  key += std::to_string(call_options.timeout.count());
+  return key;
+}
+
+// Parameter sets sent per batch when they are split across several updates.
+const size_t MAX_PARAMETER_BATCH_ROWS = 64 * 1024;
+
+// Lets servers that support it trim long values before sending them.
+const std::string MAX_LENGTH_HEADER = "max-field-size";
+
+// Lets servers that support it stop producing rows past the limit.
+const std::string MAX_ROWS_HEADER = "max-rows";
+
+/// Sets a limit hint header, removing it when the limit is zero.
+void SetLimitHeader(FlightCallOptions &call_options, const std::string &name, size_t limit) {
+  auto &headers = call_options.headers;
+  headers.erase(std::remove_if(headers.begin(), headers.end(),
+                               [&name](const std::pair<std::string, std::string> &header) {
+                                 return header.first == name;
+                               }),
+                headers.end());
+  if (limit > 0) {
+    headers.emplace_back(name, std::to_string(limit));
+  }
+}
+
+std::shared_ptr<RecordBatchTransformer>
+CreateQueryTransformer(const std::shared_ptr<FlightInfo> &flight_info,
+                       const odbcabstraction::MetadataSettings &metadata_settings) {
+  if (!metadata_settings.flatten_struct_columns_) {
+    return nullptr;
   }
+
+  std::shared_ptr<arrow::Schema> schema;
+  ThrowIfNotOK(flight_info->GetSchema(nullptr, &schema));
+  return CreateStructFlatteningTransformer(schema);
 }
 
 } // namespace
@@ -54,17 +99,67 @@ void ClosePreparedStatementIfAny(
 FlightSqlStatement::FlightSqlStatement(
     const odbcabstraction::Diagnostics& diagnostics,
     FlightSqlClient &sql_client,
+    std::shared_ptr<QueryCanceller> query_canceller,
+    std::shared_ptr<PreparedStatementCache> prepared_statement_cache,
     FlightCallOptions call_options,
     const odbcabstraction::MetadataSettings& metadata_settings)
     : diagnostics_("Apache Arrow", diagnostics.GetDataSourceComponent(), diagnostics.GetOdbcVersion()),
-      sql_client_(sql_client), call_options_(std::move(call_options)), metadata_settings_(metadata_settings) {
+      call_options_(std::move(call_options)), sql_client_(sql_client),
+      query_canceller_(std::move(query_canceller)),
+      prepared_statement_cache_(std::move(prepared_statement_cache)), prepared_from_cache_(false), paramset_size_(0),
+      parameter_bind_offset_(0), parameter_bind_type_(0), update_count_(-1),
+      paramsets_processed_(0), paramsets_succeeded_(0),
+      metadata_settings_(metadata_settings) {
   attribute_[METADATA_ID] = static_cast<size_t>(SQL_FALSE);
   attribute_[MAX_LENGTH] = static_cast<size_t>(0);
   attribute_[NOSCAN] = static_cast<size_t>(SQL_NOSCAN_OFF);
   attribute_[QUERY_TIMEOUT] = static_cast<size_t>(0);
+  attribute_[UPDATE_HINT] = static_cast<size_t>(odbcabstraction::UpdateHint_AUTO);
+  attribute_[MAX_ROWS] = static_cast<size_t>(0);
+  attribute_[SCROLLABLE] = static_cast<size_t>(0);
   call_options_.timeout = TimeoutDuration{-1};
 }
 
+FlightSqlStatement::~FlightSqlStatement() {
+  try {
+    DiscardPendingResults();
+    ReleasePreparedStatement();
+  } catch (...) {
+    // The handle is dropped either way.
+  }
+}
+
+void FlightSqlStatement::ReleasePreparedStatement() {
+  if (!prepared_statement_) {
+    return;
+  }
+
+  std::shared_ptr<PreparedStatement> prepared_statement = std::move(prepared_statement_);
+  prepared_statement_.reset();
+  if (prepared_statement_cache_) {
+    prepared_statement_cache_->Release(prepared_statement_key_, std::move(prepared_statement));
+  } else {
+    ThrowIfNotOK(prepared_statement->Close());
+  }
+}
+
+bool FlightSqlStatement::ReprepareIfInvalidated(const Status &status) {
+  // A handle taken from the cache may have been dropped by the server since,
+  // which is only noticed when it is used. The server reports it as NOT_FOUND,
+  // which Flight maps to KeyError. Other errors may come after an update ran,
+  // so retrying on them could apply it twice.
+  if (!prepared_from_cache_ || !status.IsKeyError()) {
+    return false;
+  }
+
+  ARROW_UNUSED(prepared_statement_->Close());
+  Result<std::shared_ptr<PreparedStatement>> result = sql_client_.Prepare(call_options_, prepared_query_);
+  ThrowIfNotOK(result.status());
+  prepared_statement_ = std::move(result).ValueOrDie();
+  prepared_from_cache_ = false;
+  return true;
+}
+
 bool FlightSqlStatement::SetAttribute(StatementAttributeId attribute,
                                       const Attribute &value) {
   switch (attribute) {
@@ -72,8 +167,20 @@ bool FlightSqlStatement::SetAttribute(StatementAttributeId attribute,
     return CheckIfSetToOnlyValidValue(value, static_cast<size_t>(SQL_FALSE));
   case NOSCAN:
     return CheckIfSetToOnlyValidValue(value, static_cast<size_t>(SQL_NOSCAN_OFF));
+  case UPDATE_HINT:
+    if (boost::get<size_t>(value) > odbcabstraction::UpdateHint_UPDATE) {
+      throw DriverException("Invalid attribute value", "HY024");
+    }
+    attribute_[attribute] = value;
+    return true;
   case MAX_LENGTH:
-    return CheckIfSetToOnlyValidValue(value, static_cast<size_t>(0));
+    SetLimitHeader(call_options_, MAX_LENGTH_HEADER, boost::get<size_t>(value));
+    attribute_[attribute] = value;
+    return true;
+  case MAX_ROWS:
+    SetLimitHeader(call_options_, MAX_ROWS_HEADER, boost::get<size_t>(value));
+    attribute_[attribute] = value;
+    return true;
   case QUERY_TIMEOUT:
     if (boost::get<size_t>(value) > 0) {
       call_options_.timeout =
@@ -96,86 +203,342 @@ FlightSqlStatement::GetAttribute(StatementAttributeId attribute) {
 
 boost::optional<std::shared_ptr<ResultSetMetadata>>
 FlightSqlStatement::Prepare(const std::string &query) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ReleasePreparedStatement();
+  DiscardPendingResults();
 
-  Result<std::shared_ptr<PreparedStatement>> result =
-      sql_client_.Prepare(call_options_, query);
-  ThrowIfNotOK(result.status());
+  const std::string key = GetPreparedStatementKey(query, call_options_);
+  if (prepared_statement_cache_) {
+    prepared_statement_ = prepared_statement_cache_->Acquire(key);
+  }
+  prepared_from_cache_ = prepared_statement_ != nullptr;
+  if (!prepared_statement_) {
+    Result<std::shared_ptr<PreparedStatement>> result =
+        sql_client_.Prepare(call_options_, query);
+    ThrowIfNotOK(result.status());
 
-  prepared_statement_ = *result;
+    prepared_statement_ = *result;
+  }
+  prepared_statement_key_ = key;
+  prepared_query_ = query;
+  parameter_bindings_.clear();
+  paramset_size_ = 0;
+
+  std::shared_ptr<arrow::Schema> dataset_schema = prepared_statement_->dataset_schema();
+  if (metadata_settings_.flatten_struct_columns_) {
+    dataset_schema = FlattenStructFields(dataset_schema);
+  }
 
   const auto &result_set_metadata =
       std::make_shared<FlightSqlResultSetMetadata>(
-          prepared_statement_->dataset_schema(), metadata_settings_);
+          dataset_schema, metadata_settings_);
   return boost::optional<std::shared_ptr<ResultSetMetadata>>(
       result_set_metadata);
 }
 
 bool FlightSqlStatement::ExecutePrepared() {
   assert(prepared_statement_.get() != nullptr);
+  DiscardPendingResults();
+  update_count_ = -1;
+  paramsets_processed_ = 0;
+  paramsets_succeeded_ = 0;
+
+  // Updates return a row count from a single call, without a result stream.
+  if (IsUpdate(prepared_query_)) {
+    SetResultSet(nullptr);
+    ExecuteUpdateInBatches();
+    return false;
+  }
 
+  std::shared_ptr<arrow::RecordBatch> parameters;
+  if (!parameter_bindings_.empty()) {
+    parameters = BuildParameterBatch(prepared_statement_->parameter_schema(), parameter_bindings_,
+                                     paramset_size_, parameter_bind_offset_, parameter_bind_type_);
+  }
+  ThrowIfNotOK(prepared_statement_->SetParameters(parameters));
+
+  paramsets_processed_ = paramset_size_;
   Result<std::shared_ptr<FlightInfo>> result = prepared_statement_->Execute();
+  if (!result.ok() && ReprepareIfInvalidated(result.status())) {
+    ThrowIfNotOK(prepared_statement_->SetParameters(parameters));
+    result = prepared_statement_->Execute();
+  }
   ThrowIfNotOK(result.status());
+  prepared_from_cache_ = false;
+  paramsets_succeeded_ = paramset_size_;
 
-  current_result_set_ = std::make_shared<FlightSqlResultSet>(
-      sql_client_, call_options_, result.ValueOrDie(), nullptr, diagnostics_, metadata_settings_);
+  const std::shared_ptr<FlightInfo> &flight_info = result.ValueOrDie();
+  SetResultSet(std::make_shared<FlightSqlResultSet>(
+      sql_client_, call_options_, flight_info,
+      CreateQueryTransformer(flight_info, metadata_settings_), diagnostics_, metadata_settings_,
+      boost::get<size_t>(attribute_[MAX_LENGTH]), query_canceller_,
+      boost::get<size_t>(attribute_[SCROLLABLE]) != 0));
 
   return true;
 }
 
+void FlightSqlStatement::SetParameters(const std::vector<odbcabstraction::ParameterBinding> &bindings,
+                                       size_t paramset_size, size_t bind_offset, size_t bind_type) {
+  if (!prepared_statement_) {
+    throw DriverException("Function sequence error", "HY010");
+  }
+
+  // Batches are built on execution, when the bound buffers hold the values.
+  parameter_bindings_ = bindings;
+  paramset_size_ = bindings.empty() ? 0 : paramset_size;
+  parameter_bind_offset_ = bind_offset;
+  parameter_bind_type_ = bind_type;
+}
+
+bool FlightSqlStatement::IsUpdate(const std::string &query) {
+  switch (boost::get<size_t>(attribute_[UPDATE_HINT])) {
+    case odbcabstraction::UpdateHint_QUERY:
+      return false;
+    case odbcabstraction::UpdateHint_UPDATE:
+      return true;
+    default:
+      return IsUpdateStatement(query);
+  }
+}
+
+void FlightSqlStatement::ExecuteUpdateInBatches() {
+  if (parameter_bindings_.empty()) {
+    update_count_ = static_cast<long>(ExecuteUpdateWithParameters(nullptr));
+    return;
+  }
+
+  const std::shared_ptr<arrow::Schema> parameter_schema = prepared_statement_->parameter_schema();
+  auto build_batch = [this, parameter_schema](size_t first_paramset) {
+    return BuildParameterBatch(parameter_schema, parameter_bindings_,
+                               std::min(MAX_PARAMETER_BATCH_ROWS, paramset_size_ - first_paramset),
+                               parameter_bind_offset_, parameter_bind_type_, first_paramset);
+  };
+
+  // The next batch is built while the current one is being sent.
+  std::future<std::shared_ptr<arrow::RecordBatch>> next_batch =
+      std::async(std::launch::async, build_batch, static_cast<size_t>(0));
+
+  // Batches applied before a failing one stay applied, so their count is
+  // reported along with the error.
+  update_count_ = 0;
+  for (size_t first_paramset = 0; first_paramset < paramset_size_;
+       first_paramset += MAX_PARAMETER_BATCH_ROWS) {
+    const size_t next_paramset = first_paramset + MAX_PARAMETER_BATCH_ROWS;
+    paramsets_processed_ = std::min(next_paramset, paramset_size_);
+    std::shared_ptr<arrow::RecordBatch> batch = next_batch.get();
+    if (next_paramset < paramset_size_) {
+      next_batch = std::async(std::launch::async, build_batch, next_paramset);
+    }
+
+    update_count_ += static_cast<long>(ExecuteUpdateWithParameters(std::move(batch)));
+    paramsets_succeeded_ = paramsets_processed_;
+  }
+}
+
+int64_t FlightSqlStatement::ExecuteUpdateWithParameters(std::shared_ptr<arrow::RecordBatch> parameters) {
+  ThrowIfNotOK(prepared_statement_->SetParameters(parameters));
+  Result<int64_t> result = prepared_statement_->ExecuteUpdate();
+  if (!result.ok() && ReprepareIfInvalidated(result.status())) {
+    ThrowIfNotOK(prepared_statement_->SetParameters(parameters));
+    result = prepared_statement_->ExecuteUpdate();
+  }
+  ThrowIfNotOK(result.status());
+  prepared_from_cache_ = false;
+  return result.ValueOrDie();
+}
+
+void FlightSqlStatement::ResetExecution() {
+  ReleasePreparedStatement();
+  DiscardPendingResults();
+  update_count_ = -1;
+  paramsets_processed_ = 0;
+  paramsets_succeeded_ = 0;
+}
+
 bool FlightSqlStatement::Execute(const std::string &query) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ResetExecution();
+
+  // When enabled on the connection, a batch returns one result per statement,
+  // see MoreResults(). Otherwise the whole text goes to the server.
+  if (metadata_settings_.split_statement_batches_) {
+    std::vector<std::string> statements = SplitStatements(query);
+    if (statements.size() > 1) {
+      pending_statements_.assign(statements.begin(), statements.end());
+      StartNextResult();
+      return TakeNextResult();
+    }
+  }
+
+  // Frequently repeated queries run as prepared statements, so the server
+  // reuses their plan through the cached handle.
+  if (prepared_statement_cache_ && prepared_statement_cache_->RecordDirectExecution(query)) {
+    Prepare(query);
+    return ExecutePrepared();
+  }
+
+  return ExecuteQuery(query);
+}
+
+bool FlightSqlStatement::ExecuteSingle(const std::string &query) {
+  ResetExecution();
+  return ExecuteQuery(query);
+}
+
+bool FlightSqlStatement::ExecuteQuery(const std::string &query) {
+  BatchResult result = RunQuery(query, IsUpdate(query), call_options_,
+                                boost::get<size_t>(attribute_[MAX_LENGTH]),
+                                boost::get<size_t>(attribute_[SCROLLABLE]) != 0);
+  SetResultSet(result.result_set);
+  update_count_ = result.update_count;
+  return result.result_set != nullptr;
+}
+
+FlightSqlStatement::BatchResult
+FlightSqlStatement::RunQuery(const std::string &query, bool is_update,
+                             const FlightCallOptions &call_options, size_t max_length,
+                             bool scrollable) {
+  BatchResult batch_result = {nullptr, -1};
+  if (is_update) {
+    Result<int64_t> result = sql_client_.ExecuteUpdate(call_options, query);
+    ThrowIfNotOK(result.status());
+
+    batch_result.update_count = static_cast<long>(result.ValueOrDie());
+    return batch_result;
+  }
 
   Result<std::shared_ptr<FlightInfo>> result =
-      sql_client_.Execute(call_options_, query);
+      sql_client_.Execute(call_options, query);
   ThrowIfNotOK(result.status());
 
-  current_result_set_ = std::make_shared<FlightSqlResultSet>(
-      sql_client_, call_options_, result.ValueOrDie(), nullptr, diagnostics_, metadata_settings_);
+  const std::shared_ptr<FlightInfo> &flight_info = result.ValueOrDie();
+  batch_result.result_set = std::make_shared<FlightSqlResultSet>(
+      sql_client_, call_options, flight_info,
+      CreateQueryTransformer(flight_info, metadata_settings_), diagnostics_, metadata_settings_,
+      max_length, query_canceller_, scrollable);
+  return batch_result;
+}
+
+void FlightSqlStatement::StartNextResult() {
+  if (pending_statements_.empty()) {
+    return;
+  }
+
+  std::string query = std::move(pending_statements_.front());
+  pending_statements_.pop_front();
+
+  // The worker gets its own copy of the settings the statement may change
+  // meanwhile.
+  const bool is_update = IsUpdate(query);
+  const FlightCallOptions call_options = call_options_;
+  const size_t max_length = boost::get<size_t>(attribute_[MAX_LENGTH]);
+  const bool scrollable = boost::get<size_t>(attribute_[SCROLLABLE]) != 0;
+  auto run_query = [this, query, is_update, call_options, max_length, scrollable]() {
+    return RunQuery(query, is_update, call_options, max_length, scrollable);
+  };
+
+  // Queries are started while the application reads the current result.
+  // Updates only run once the application reaches them, so they cannot
+  // change data the statements ahead of them are still returning.
+  next_result_ = std::async(is_update ? std::launch::deferred : std::launch::async, run_query);
+}
+
+bool FlightSqlStatement::TakeNextResult() {
+  BatchResult result;
+  try {
+    result = next_result_.get();
+  } catch (...) {
+    // The rest of the batch is abandoned after an error.
+    DiscardPendingResults();
+    throw;
+  }
+
+  SetResultSet(result.result_set);
+  update_count_ = result.update_count;
+  StartNextResult();
+  return result.result_set != nullptr;
+}
+
+bool FlightSqlStatement::MoreResults() {
+  std::shared_ptr<ResultSet> current_result_set = std::atomic_load(&current_result_set_);
+  if (current_result_set) {
+    current_result_set->Close();
+  }
+
+  if (!next_result_.valid()) {
+    SetResultSet(nullptr);
+    update_count_ = -1;
+    return false;
+  }
 
+  TakeNextResult();
   return true;
 }
 
+void FlightSqlStatement::DiscardPendingResults() {
+  pending_statements_.clear();
+  if (!next_result_.valid()) {
+    return;
+  }
+
+  // Deferred updates are dropped without running.
+  if (next_result_.wait_for(std::chrono::seconds(0)) == std::future_status::deferred) {
+    next_result_ = std::future<BatchResult>();
+    return;
+  }
+
+  // A prefetched result set is closed, which cancels its query.
+  try {
+    BatchResult result = next_result_.get();
+    if (result.result_set) {
+      result.result_set->Close();
+    }
+  } catch (...) {
+    // Errors of discarded results are not reported.
+  }
+}
+
 std::shared_ptr<ResultSet> FlightSqlStatement::GetResultSet() {
   return current_result_set_;
 }
 
-long FlightSqlStatement::GetUpdateCount() { return -1; }
+long FlightSqlStatement::GetUpdateCount() { return update_count_; }
+
+size_t FlightSqlStatement::GetParamsetsProcessed() { return paramsets_processed_; }
+
+size_t FlightSqlStatement::GetParamsetsSucceeded() { return paramsets_succeeded_; }
 
 std::shared_ptr<odbcabstraction::ResultSet> FlightSqlStatement::GetTables(
     const std::string *catalog_name, const std::string *schema_name,
     const std::string *table_name, const std::string *table_type,
     const ColumnNames &column_names) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ReleasePreparedStatement();
+  DiscardPendingResults();
 
   std::vector<std::string> table_types;
 
   if ((catalog_name && *catalog_name == "%") &&
       (schema_name && schema_name->empty()) &&
       (table_name && table_name->empty())) {
-    current_result_set_ =
-        GetTablesForSQLAllCatalogs(
-                column_names, call_options_, sql_client_, diagnostics_, metadata_settings_);
+    SetResultSet(GetTablesForSQLAllCatalogs(
+        column_names, call_options_, sql_client_, diagnostics_, metadata_settings_));
   } else if ((catalog_name && catalog_name->empty()) &&
              (schema_name && *schema_name == "%") &&
              (table_name && table_name->empty())) {
-    current_result_set_ = GetTablesForSQLAllDbSchemas(
-        column_names, call_options_, sql_client_, schema_name, diagnostics_, metadata_settings_);
+    SetResultSet(GetTablesForSQLAllDbSchemas(
+        column_names, call_options_, sql_client_, schema_name, diagnostics_, metadata_settings_));
   } else if ((catalog_name && catalog_name->empty()) &&
              (schema_name && schema_name->empty()) &&
              (table_name && table_name->empty()) &&
              (table_type && *table_type == "%")) {
-    current_result_set_ =
-        GetTablesForSQLAllTableTypes(
-                column_names, call_options_, sql_client_, diagnostics_, metadata_settings_);
+    SetResultSet(GetTablesForSQLAllTableTypes(
+        column_names, call_options_, sql_client_, diagnostics_, metadata_settings_));
   } else {
     if (table_type) {
       ParseTableTypes(*table_type, table_types);
     }
 
-    current_result_set_ = GetTablesForGenericUse(
+    SetResultSet(GetTablesForGenericUse(
         column_names, call_options_, sql_client_, catalog_name, schema_name,
-        table_name, table_types, diagnostics_, metadata_settings_);
+        table_name, table_types, diagnostics_, metadata_settings_));
   }
 
   return current_result_set_;
@@ -204,7 +567,8 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetTables_V3(
 std::shared_ptr<ResultSet> FlightSqlStatement::GetColumns_V2(
     const std::string *catalog_name, const std::string *schema_name,
     const std::string *table_name, const std::string *column_name) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ReleasePreparedStatement();
+  DiscardPendingResults();
 
   Result<std::shared_ptr<FlightInfo>> result = sql_client_.GetTables(
       call_options_, catalog_name, schema_name, table_name, true, nullptr);
@@ -215,8 +579,8 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetColumns_V2(
   auto transformer = std::make_shared<GetColumns_Transformer>(
       metadata_settings_, odbcabstraction::V_2, column_name);
 
-  current_result_set_ = std::make_shared<FlightSqlResultSet>(
-      sql_client_, call_options_, flight_info, transformer, diagnostics_, metadata_settings_);
+  SetResultSet(std::make_shared<FlightSqlResultSet>(
+      sql_client_, call_options_, flight_info, transformer, diagnostics_, metadata_settings_));
 
   return current_result_set_;
 }
@@ -224,7 +588,8 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetColumns_V2(
 std::shared_ptr<ResultSet> FlightSqlStatement::GetColumns_V3(
     const std::string *catalog_name, const std::string *schema_name,
     const std::string *table_name, const std::string *column_name) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ReleasePreparedStatement();
+  DiscardPendingResults();
 
   Result<std::shared_ptr<FlightInfo>> result = sql_client_.GetTables(
       call_options_, catalog_name, schema_name, table_name, true, nullptr);
@@ -235,14 +600,15 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetColumns_V3(
   auto transformer = std::make_shared<GetColumns_Transformer>(
       metadata_settings_, odbcabstraction::V_3, column_name);
 
-  current_result_set_ = std::make_shared<FlightSqlResultSet>(
-      sql_client_, call_options_, flight_info, transformer, diagnostics_, metadata_settings_);
+  SetResultSet(std::make_shared<FlightSqlResultSet>(
+      sql_client_, call_options_, flight_info, transformer, diagnostics_, metadata_settings_));
 
   return current_result_set_;
 }
 
 std::shared_ptr<ResultSet> FlightSqlStatement::GetTypeInfo_V2(int16_t data_type) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ReleasePreparedStatement();
+  DiscardPendingResults();
 
   Result<std::shared_ptr<FlightInfo>> result = sql_client_.GetXdbcTypeInfo(
           call_options_);
@@ -253,14 +619,15 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetTypeInfo_V2(int16_t data_type)
   auto transformer = std::make_shared<GetTypeInfo_Transformer>(
           metadata_settings_, odbcabstraction::V_2, data_type);
 
-  current_result_set_ = std::make_shared<FlightSqlResultSet>(
-      sql_client_, call_options_, flight_info, transformer, diagnostics_, metadata_settings_);
+  SetResultSet(std::make_shared<FlightSqlResultSet>(
+      sql_client_, call_options_, flight_info, transformer, diagnostics_, metadata_settings_));
 
   return current_result_set_;
 }
 
 std::shared_ptr<ResultSet> FlightSqlStatement::GetTypeInfo_V3(int16_t data_type) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ReleasePreparedStatement();
+  DiscardPendingResults();
 
   Result<std::shared_ptr<FlightInfo>> result = sql_client_.GetXdbcTypeInfo(
           call_options_);
@@ -271,8 +638,8 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetTypeInfo_V3(int16_t data_type)
   auto transformer = std::make_shared<GetTypeInfo_Transformer>(
           metadata_settings_, odbcabstraction::V_3, data_type);
 
-  current_result_set_ = std::make_shared<FlightSqlResultSet>(
-      sql_client_, call_options_, flight_info, transformer, diagnostics_, metadata_settings_);
+  SetResultSet(std::make_shared<FlightSqlResultSet>(
+      sql_client_, call_options_, flight_info, transformer, diagnostics_, metadata_settings_));
 
   return current_result_set_;
 }
@@ -280,7 +647,8 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetTypeInfo_V3(int16_t data_type)
 std::shared_ptr<ResultSet> FlightSqlStatement::GetPrimaryKeys(
     const std::string *catalog_name, const std::string *schema_name,
     const std::string *table_name) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ReleasePreparedStatement();
+  DiscardPendingResults();
 
   auto schema = arrow::schema({
     arrow::field("TABLE_CAT", arrow::utf8(), true),      // nullable
@@ -297,8 +665,8 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetPrimaryKeys(
   ThrowIfNotOK(flight_info_result.status());
   auto flight_info = std::make_shared<arrow::flight::FlightInfo>(std::move(flight_info_result.ValueOrDie()));
 
-  current_result_set_ = std::make_shared<FlightSqlResultSet>(
-    sql_client_, call_options_, flight_info, nullptr, diagnostics_, metadata_settings_);
+  SetResultSet(std::make_shared<FlightSqlResultSet>(
+    sql_client_, call_options_, flight_info, nullptr, diagnostics_, metadata_settings_));
 
   return current_result_set_;
 }
@@ -307,7 +675,8 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetForeignKeys(
     const std::string *pk_catalog_name, const std::string *pk_schema_name,
     const std::string *pk_table_name, const std::string *fk_catalog_name,
     const std::string *fk_schema_name, const std::string *fk_table_name) {
-  ClosePreparedStatementIfAny(prepared_statement_);
+  ReleasePreparedStatement();
+  DiscardPendingResults();
 
   auto schema = arrow::schema({
     arrow::field("PKTABLE_CAT", arrow::utf8(), true),     // nullable
@@ -332,8 +701,8 @@ std::shared_ptr<ResultSet> FlightSqlStatement::GetForeignKeys(
   ThrowIfNotOK(flight_info_result.status());
   auto flight_info = std::make_shared<arrow::flight::FlightInfo>(std::move(flight_info_result.ValueOrDie()));
 
-  current_result_set_ = std::make_shared<FlightSqlResultSet>(
-    sql_client_, call_options_, flight_info, nullptr, diagnostics_, metadata_settings_);
+  SetResultSet(std::make_shared<FlightSqlResultSet>(
+    sql_client_, call_options_, flight_info, nullptr, diagnostics_, metadata_settings_));
 
   return current_result_set_;
 }
@@ -342,9 +711,16 @@ odbcabstraction::Diagnostics &FlightSqlStatement::GetDiagnostics() {
   return diagnostics_;
 }
 
+void FlightSqlStatement::SetResultSet(std::shared_ptr<ResultSet> result_set) {
+  std::atomic_store(&current_result_set_, std::move(result_set));
+}
+
 void FlightSqlStatement::Cancel() {
-  if (!current_result_set_) return;
-  current_result_set_->Cancel();
+  // May run on another thread while this statement is in use, so the result
+  // set is read atomically and kept alive while it is cancelled.
+  std::shared_ptr<ResultSet> result_set = std::atomic_load(&current_result_set_);
+  if (!result_set) return;
+  result_set->Cancel();
 }
 
 } // namespace flight_sql
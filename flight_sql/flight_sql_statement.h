@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include "flight_sql_query_cancel.h"
 #include "flight_sql_statement_get_tables.h"
+#include "prepared_statement_cache.h"
 #include "odbcabstraction/types.h"
 #include <odbcabstraction/spi/statement.h>
 #include <odbcabstraction/diagnostics.h>
@@ -15,20 +17,100 @@
 #include <arrow/flight/sql/api.h>
 #include <arrow/flight/types.h>
 
+#include <deque>
+#include <future>
+
 namespace driver {
 namespace flight_sql {
 
 class FlightSqlStatement : public odbcabstraction::Statement {
 
 private:
+  /// \brief The result of one statement: a result set, or an update count.
+  struct BatchResult {
+    std::shared_ptr<odbcabstraction::ResultSet> result_set;
+    long update_count;
+  };
+
   odbcabstraction::Diagnostics diagnostics_;
   std::map<StatementAttributeId, Attribute> attribute_;
   arrow::flight::FlightCallOptions call_options_;
   arrow::flight::sql::FlightSqlClient &sql_client_;
+  // Cancels abandoned queries on the server, shared with the connection.
+  std::shared_ptr<QueryCanceller> query_canceller_;
+  // Prepared statement handles shared with the other statements of the
+  // connection. Null when caching is disabled.
+  std::shared_ptr<PreparedStatementCache> prepared_statement_cache_;
   std::shared_ptr<odbcabstraction::ResultSet> current_result_set_;
   std::shared_ptr<arrow::flight::sql::PreparedStatement> prepared_statement_;
+  std::string prepared_query_;
+  std::string prepared_statement_key_;
+  // Set while the prepared statement comes from the cache and has not been
+  // executed yet, so it may have been invalidated by the server.
+  bool prepared_from_cache_;
+  std::vector<odbcabstraction::ParameterBinding> parameter_bindings_;
+  size_t paramset_size_;
+  size_t parameter_bind_offset_;
+  size_t parameter_bind_type_;
+  long update_count_;
+  // Parameter sets sent and applied by the last execution.
+  size_t paramsets_processed_;
+  size_t paramsets_succeeded_;
+  // Statements of the executed batch that were not started yet.
+  std::deque<std::string> pending_statements_;
+  // The result following the current one in the executed batch.
+  std::future<BatchResult> next_result_;
   const odbcabstraction::MetadataSettings& metadata_settings_;
 
+  /// \brief Returns the prepared statement to the cache, or closes it when
+  /// caching is disabled.
+  void ReleasePreparedStatement();
+
+  /// \brief Prepares the query again if the status shows a cached handle was
+  /// invalidated by the server. Returns true if the call should be retried.
+  bool ReprepareIfInvalidated(const arrow::Status &status);
+
+  /// \brief Executes the prepared statement as an update with the given
+  /// parameters. Returns the update count.
+  int64_t ExecuteUpdateWithParameters(std::shared_ptr<arrow::RecordBatch> parameters);
+
+  /// \brief Releases the prepared statement and the results of the previous
+  /// execution.
+  void ResetExecution();
+
+  /// \brief Executes the query as a single statement and makes its result
+  /// current.
+  bool ExecuteQuery(const std::string &query);
+
+  /// \brief Runs a single query, or update, with the given settings. Does
+  /// not change the state of the statement, so it may run on another thread.
+  BatchResult RunQuery(const std::string &query, bool is_update,
+                       const arrow::flight::FlightCallOptions &call_options,
+                       size_t max_length, bool scrollable);
+
+  /// \brief Starts the next pending statement of the batch.
+  void StartNextResult();
+
+  /// \brief Makes the started statement the current result and starts the
+  /// one after it. Returns true if the result is a result set.
+  bool TakeNextResult();
+
+  /// \brief Drops the results left in the executed batch.
+  void DiscardPendingResults();
+
+  /// \brief Replaces the current result set, which Cancel() may read from
+  /// another thread.
+  void SetResultSet(std::shared_ptr<odbcabstraction::ResultSet> result_set);
+
+  /// \brief Returns true if the statement should be executed as an update,
+  /// according to the UPDATE_HINT attribute.
+  bool IsUpdate(const std::string &query);
+
+  /// \brief Executes the prepared statement as an update, sending parameter
+  /// sets in bounded batches. The update count and the parameter sets
+  /// processed are kept up to date, so they are known when a batch fails.
+  void ExecuteUpdateInBatches();
+
   std::shared_ptr<odbcabstraction::ResultSet>
   GetTables(const std::string *catalog_name, const std::string *schema_name,
             const std::string *table_name, const std::string *table_type,
@@ -38,9 +120,13 @@ public:
   FlightSqlStatement(
       const odbcabstraction::Diagnostics &diagnostics,
       arrow::flight::sql::FlightSqlClient &sql_client,
+      std::shared_ptr<QueryCanceller> query_canceller,
+      std::shared_ptr<PreparedStatementCache> prepared_statement_cache,
       arrow::flight::FlightCallOptions call_options,
       const odbcabstraction::MetadataSettings& metadata_settings);
 
+  ~FlightSqlStatement() override;
+
   bool SetAttribute(StatementAttributeId attribute, const Attribute &value) override;
 
   boost::optional<Attribute> GetAttribute(StatementAttributeId attribute) override;
@@ -50,12 +136,23 @@ public:
 
   bool ExecutePrepared() override;
 
+  void SetParameters(const std::vector<odbcabstraction::ParameterBinding> &bindings,
+                     size_t paramset_size, size_t bind_offset, size_t bind_type) override;
+
   bool Execute(const std::string &query) override;
 
+  bool ExecuteSingle(const std::string &query) override;
+
   std::shared_ptr<odbcabstraction::ResultSet> GetResultSet() override;
 
+  bool MoreResults() override;
+
   long GetUpdateCount() override;
 
+  size_t GetParamsetsProcessed() override;
+
+  size_t GetParamsetsSucceeded() override;
+
   std::shared_ptr<odbcabstraction::ResultSet>
   GetTables_V2(const std::string *catalog_name, const std::string *schema_name,
                const std::string *table_name, const std::string *table_type) override;
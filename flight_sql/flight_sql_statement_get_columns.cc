@@ -85,7 +85,7 @@ Transform_inner(const odbcabstraction::OdbcVersion odbc_version,
     const auto &table_catalog = reader.GetCatalogName();
     const auto &table_schema = reader.GetDbSchemaName();
     const auto &table_name = reader.GetTableName();
-    const std::shared_ptr<Schema> &schema = reader.GetSchema();
+    std::shared_ptr<Schema> schema = reader.GetSchema();
     if (schema == nullptr) {
       // TODO: Remove this if after fixing TODO on GetTablesReader::GetSchema()
       // This is because of a problem on Dremio server, where complex types columns
@@ -93,6 +93,9 @@ Transform_inner(const odbcabstraction::OdbcVersion odbc_version,
       // it by now.
       continue;
     }
+    if (metadata_settings.flatten_struct_columns_) {
+      schema = FlattenStructFields(schema);
+    }
     for (int i = 0; i < schema->num_fields(); ++i) {
       const std::shared_ptr<Field> &field = schema->field(i);
 
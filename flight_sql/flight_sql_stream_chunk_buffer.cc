@@ -17,7 +17,12 @@ FlightStreamChunkBuffer::FlightStreamChunkBuffer(FlightSqlClient &flight_sql_cli
                                                  const arrow::flight::FlightCallOptions &call_options,
                                                  const std::shared_ptr<FlightInfo> &flight_info,
                                                  size_t queue_capacity,
-                                                 bool use_extended_flightsql_buffer): queue_(queue_capacity, use_extended_flightsql_buffer) {
+                                                 bool use_extended_flightsql_buffer,
+                                                 size_t spill_threshold)
+    : queue_(queue_capacity, use_extended_flightsql_buffer), exhausted_(false) {
+  if (spill_threshold > 0) {
+    spilling_queue_.reset(new SpillingQueue(static_cast<int64_t>(spill_threshold)));
+  }
 
   // FIXME: Endpoint iteration should consider endpoints may be at different hosts
   for (const auto & endpoint : flight_info->endpoints()) {
@@ -26,6 +31,15 @@ FlightStreamChunkBuffer::FlightStreamChunkBuffer(FlightSqlClient &flight_sql_cli
     auto result = flight_sql_client.DoGet(call_options, ticket);
     ThrowIfNotOK(result.status());
     std::shared_ptr<FlightStreamReader> stream_reader_ptr(std::move(result.ValueOrDie()));
+    stream_readers_.push_back(stream_reader_ptr);
+
+    if (spilling_queue_) {
+      spilling_queue_->AddProducer([=]() -> Result<std::shared_ptr<arrow::RecordBatch>> {
+        ARROW_ASSIGN_OR_RAISE(FlightStreamChunk chunk, stream_reader_ptr->Next());
+        return chunk.data;
+      });
+      continue;
+    }
 
     BlockingQueue<Result<FlightStreamChunk>>::Supplier supplier = [=] {
       auto result = stream_reader_ptr->Next();
@@ -39,12 +53,32 @@ FlightStreamChunkBuffer::FlightStreamChunkBuffer(FlightSqlClient &flight_sql_cli
 }
 
 bool FlightStreamChunkBuffer::GetNext(FlightStreamChunk *chunk) {
+  if (spilling_queue_) {
+    Result<std::shared_ptr<arrow::RecordBatch>> result;
+    if (!spilling_queue_->Pop(&result)) {
+      exhausted_ = true;
+      return false;
+    }
+
+    if (!result.status().ok()) {
+      exhausted_ = true;
+      Close();
+      throw odbcabstraction::DriverException(result.status().message());
+    }
+    chunk->data = std::move(result).ValueOrDie();
+    chunk->app_metadata = nullptr;
+    return true;
+  }
+
   Result<FlightStreamChunk> result;
   if (!queue_.Pop(&result)) {
+    exhausted_ = true;
     return false;
   }
 
   if (!result.status().ok()) {
+    // The server ended the stream with an error, there is nothing to cancel.
+    exhausted_ = true;
     Close();
     throw odbcabstraction::DriverException(result.status().message());
   }
@@ -53,7 +87,17 @@ bool FlightStreamChunkBuffer::GetNext(FlightStreamChunk *chunk) {
 }
 
 void FlightStreamChunkBuffer::Close() {
+  // Producers may be blocked in Next() until the server sends another batch,
+  // and closing the queue joins them. Cancelling the calls unblocks them.
+  if (!exhausted_) {
+    for (const auto &stream_reader : stream_readers_) {
+      stream_reader->Cancel();
+    }
+  }
   queue_.Close();
+  if (spilling_queue_) {
+    spilling_queue_->Close();
+  }
 }
 
 FlightStreamChunkBuffer::~FlightStreamChunkBuffer() {
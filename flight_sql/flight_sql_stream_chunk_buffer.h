@@ -6,10 +6,14 @@
 
 #pragma once
 
+#include "spilling_queue.h"
+
 #include <arrow/flight/client.h>
 #include <arrow/flight/sql/client.h>
 #include <odbcabstraction/blocking_queue.h>
 
+#include <atomic>
+#include <memory>
 
 namespace driver {
 namespace flight_sql {
@@ -23,20 +27,31 @@ using driver::odbcabstraction::BlockingQueue;
 
 class FlightStreamChunkBuffer {
   BlockingQueue<Result<FlightStreamChunk>> queue_;
+  // Used instead of queue_ when batches may be spilled to disk.
+  std::unique_ptr<SpillingQueue> spilling_queue_;
+  std::vector<std::shared_ptr<FlightStreamReader>> stream_readers_;
+  std::atomic<bool> exhausted_;
 
 public:
   FlightStreamChunkBuffer(FlightSqlClient &flight_sql_client,
                           const arrow::flight::FlightCallOptions &call_options,
                           const std::shared_ptr<FlightInfo> &flight_info,
                           size_t queue_capacity = 5,
-                          bool use_extended_flightsql_buffer = false);
+                          bool use_extended_flightsql_buffer = false,
+                          size_t spill_threshold = 0);
 
   ~FlightStreamChunkBuffer();
 
+  /// \brief Stops reading the streams. Readers waiting on the server are
+  /// cancelled rather than waited for, so this returns promptly. Safe to call
+  /// from another thread while chunks are being read.
   void Close();
 
   bool GetNext(FlightStreamChunk* chunk);
 
+  /// \brief Returns true once every stream was read to its end.
+  bool IsExhausted() const { return exhausted_; }
+
 };
 
 }
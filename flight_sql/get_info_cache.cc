@@ -494,13 +494,10 @@ bool GetInfoCache::LoadInfoFromServer() {
                 reinterpret_cast<arrow::BooleanScalar *>(scalar->value.get())->value;
             break;
           }
-          case SqlInfoOptions::SQL_BATCH_UPDATES_SUPPORTED: {
-            info_[SQL_BATCH_SUPPORT] = static_cast<uint32_t>(
-                reinterpret_cast<arrow::BooleanScalar *>(scalar->value.get())->value
-                    ? SQL_BS_ROW_COUNT_EXPLICIT
-                    : 0);
+          case SqlInfoOptions::SQL_BATCH_UPDATES_SUPPORTED:
+            // Not used. Batches are split by the driver when enabled on the
+            // connection, see FlightSqlConnection::Connect().
             break;
-          }
           case SqlInfoOptions::SQL_SAVEPOINTS_SUPPORTED:
             // Not used.
             break;
@@ -1121,7 +1118,7 @@ void GetInfoCache::LoadDefaultsForMissingEntries() {
   SetDefaultIfMissing(info_, SQL_ALTER_DOMAIN, static_cast<uint32_t>(0));
   SetDefaultIfMissing(info_, SQL_ALTER_TABLE, static_cast<uint32_t>(0));
   SetDefaultIfMissing(info_, SQL_ASYNC_MODE,
-                      static_cast<uint32_t>(SQL_AM_NONE));
+                      static_cast<uint32_t>(SQL_AM_STATEMENT));
   SetDefaultIfMissing(info_, SQL_BATCH_ROW_COUNT, static_cast<uint32_t>(0));
   SetDefaultIfMissing(info_, SQL_BATCH_SUPPORT, static_cast<uint32_t>(0));
   SetDefaultIfMissing(info_, SQL_BOOKMARK_PERSISTENCE,
@@ -1256,6 +1253,7 @@ void GetInfoCache::LoadDefaultsForMissingEntries() {
   SetDefaultIfMissing(info_, SQL_MAX_TABLES_IN_SELECT,
                       static_cast<uint16_t>(0));
   SetDefaultIfMissing(info_, SQL_MAX_USER_NAME_LEN, static_cast<uint16_t>(0));
+  SetDefaultIfMissing(info_, SQL_MULT_RESULT_SETS, "N");
   SetDefaultIfMissing(info_, SQL_NON_NULLABLE_COLUMNS,
                       static_cast<uint16_t>(SQL_NNC_NULL));
   SetDefaultIfMissing(info_, SQL_NULL_COLLATION,
@@ -8,14 +8,19 @@
 
 #include <arrow/scalar.h>
 #include <arrow/builder.h>
+#include <arrow/buffer_builder.h>
+#include <arrow/util/bitmap_ops.h>
+#include <arrow/util/checked_cast.h>
 #include <arrow/visitor.h>
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/writer.h>
 #include "utils.h"
 #include <boost/beast/core/detail/base64.hpp>
+#include <limits>
 
 using namespace arrow;
 using namespace boost::beast::detail;
+using arrow::internal::checked_cast;
 using driver::flight_sql::ThrowIfNotOK;
 
 namespace {
@@ -276,6 +281,199 @@ public:
     return Status::NotImplemented("Cannot convert ExtensionScalar to JSON.");
   }
 };
+
+/// Output stream for rapidjson that appends to a std::string, so the JSON for
+/// every row lands in one contiguous buffer that can be handed to Arrow as is.
+class StringOutputStream {
+public:
+  typedef char Ch;
+
+  explicit StringOutputStream(std::string &output) : output_(output) {}
+
+  void Put(Ch c) { output_.push_back(c); }
+
+  void Flush() {}
+
+private:
+  std::string &output_;
+};
+
+/// Serializes arrays to JSON by walking their buffers and child arrays
+/// directly, without materializing a Scalar for every nested value. Values
+/// that need Arrow's string formatting (temporal and interval types, unions)
+/// are still written through the Scalar based converter.
+class ArrayToJson {
+private:
+  std::string data_;
+  StringOutputStream stream_{data_};
+  rapidjson::Writer<StringOutputStream> writer_{stream_};
+
+  Status WriteBase64(const util::string_view &view) {
+    size_t encoded_size = base64::encoded_size(view.length());
+    std::vector<char> encoded(std::max(encoded_size, static_cast<size_t>(1)));
+    base64::encode(&encoded[0], view.data(), view.length());
+    writer_.String(&encoded[0], encoded_size, true);
+    return Status::OK();
+  }
+
+  template <typename ListArrayT>
+  Status WriteList(const ListArrayT &array, int64_t index) {
+    const Array &values = *array.values();
+    const int64_t begin = array.value_offset(index);
+    const int64_t end = begin + array.value_length(index);
+
+    writer_.StartArray();
+    for (int64_t i = begin; i < end; ++i) {
+      RETURN_NOT_OK(WriteValue(values, i));
+    }
+    writer_.EndArray();
+    return Status::OK();
+  }
+
+  Status WriteStruct(const StructArray &array, int64_t index) {
+    const auto &type = checked_cast<const StructType &>(*array.type());
+
+    writer_.StartObject();
+    for (int i = 0; i < type.num_fields(); ++i) {
+      const std::string &name = type.field(i)->name();
+      writer_.Key(name.data(), static_cast<rapidjson::SizeType>(name.length()), true);
+      RETURN_NOT_OK(WriteValue(*array.field(i), index));
+    }
+    writer_.EndObject();
+    return Status::OK();
+  }
+
+  Status WriteWithScalar(const Array &array, int64_t index) {
+    ARROW_ASSIGN_OR_RAISE(auto scalar, array.GetScalar(index))
+    const std::string json = driver::flight_sql::ConvertToJson(*scalar);
+    writer_.RawValue(json.data(), json.length(), rapidjson::kStringType);
+    return Status::OK();
+  }
+
+  Status WriteValue(const Array &array, int64_t index) {
+    if (array.IsNull(index)) {
+      writer_.Null();
+      return Status::OK();
+    }
+
+    switch (array.type_id()) {
+      case Type::NA:
+        writer_.Null();
+        break;
+      case Type::BOOL:
+        writer_.Bool(checked_cast<const BooleanArray &>(array).Value(index));
+        break;
+      case Type::INT8:
+        writer_.Int(checked_cast<const Int8Array &>(array).Value(index));
+        break;
+      case Type::INT16:
+        writer_.Int(checked_cast<const Int16Array &>(array).Value(index));
+        break;
+      case Type::INT32:
+        writer_.Int(checked_cast<const Int32Array &>(array).Value(index));
+        break;
+      case Type::INT64:
+        writer_.Int64(checked_cast<const Int64Array &>(array).Value(index));
+        break;
+      case Type::UINT8:
+        writer_.Uint(checked_cast<const UInt8Array &>(array).Value(index));
+        break;
+      case Type::UINT16:
+        writer_.Uint(checked_cast<const UInt16Array &>(array).Value(index));
+        break;
+      case Type::UINT32:
+        writer_.Uint(checked_cast<const UInt32Array &>(array).Value(index));
+        break;
+      case Type::UINT64:
+        writer_.Uint64(checked_cast<const UInt64Array &>(array).Value(index));
+        break;
+      case Type::HALF_FLOAT:
+        return Status::NotImplemented("Cannot convert HalfFloatScalar to JSON.");
+      case Type::FLOAT:
+        writer_.Double(checked_cast<const FloatArray &>(array).Value(index));
+        break;
+      case Type::DOUBLE:
+        writer_.Double(checked_cast<const DoubleArray &>(array).Value(index));
+        break;
+      case Type::STRING: {
+        const auto view = checked_cast<const StringArray &>(array).GetView(index);
+        writer_.String(view.data(), static_cast<rapidjson::SizeType>(view.length()));
+        break;
+      }
+      case Type::LARGE_STRING: {
+        const auto view = checked_cast<const LargeStringArray &>(array).GetView(index);
+        writer_.String(view.data(), static_cast<rapidjson::SizeType>(view.length()));
+        break;
+      }
+      case Type::BINARY:
+        return WriteBase64(checked_cast<const BinaryArray &>(array).GetView(index));
+      case Type::LARGE_BINARY:
+        return WriteBase64(checked_cast<const LargeBinaryArray &>(array).GetView(index));
+      case Type::FIXED_SIZE_BINARY:
+        return WriteBase64(checked_cast<const FixedSizeBinaryArray &>(array).GetView(index));
+      case Type::DECIMAL128: {
+        const std::string value = checked_cast<const Decimal128Array &>(array).FormatValue(index);
+        writer_.RawValue(value.data(), value.length(), rapidjson::kNumberType);
+        break;
+      }
+      case Type::DECIMAL256: {
+        const std::string value = checked_cast<const Decimal256Array &>(array).FormatValue(index);
+        writer_.RawValue(value.data(), value.length(), rapidjson::kNumberType);
+        break;
+      }
+      case Type::LIST:
+        return WriteList(checked_cast<const ListArray &>(array), index);
+      case Type::LARGE_LIST:
+        return WriteList(checked_cast<const LargeListArray &>(array), index);
+      case Type::MAP:
+        return WriteList(checked_cast<const MapArray &>(array), index);
+      case Type::FIXED_SIZE_LIST:
+        return WriteList(checked_cast<const FixedSizeListArray &>(array), index);
+      case Type::STRUCT:
+        return WriteStruct(checked_cast<const StructArray &>(array), index);
+      case Type::DICTIONARY:
+        return Status::NotImplemented("Cannot convert DictionaryScalar to JSON.");
+      case Type::EXTENSION:
+        return Status::NotImplemented("Cannot convert ExtensionScalar to JSON.");
+      default:
+        return WriteWithScalar(array, index);
+    }
+
+    return Status::OK();
+  }
+
+public:
+  Result<std::shared_ptr<Array>> Convert(const Array &input) {
+    const int64_t length = input.length();
+    data_.clear();
+
+    TypedBufferBuilder<int32_t> offsets_builder;
+    RETURN_NOT_OK(offsets_builder.Reserve(length + 1));
+    offsets_builder.UnsafeAppend(0);
+
+    for (int64_t i = 0; i < length; ++i) {
+      if (!input.IsNull(i)) {
+        writer_.Reset(stream_);
+        RETURN_NOT_OK(WriteValue(input, i));
+      }
+      if (data_.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        return Status::CapacityError("JSON output exceeds the maximum string array size.");
+      }
+      offsets_builder.UnsafeAppend(static_cast<int32_t>(data_.size()));
+    }
+
+    std::shared_ptr<Buffer> null_bitmap;
+    if (input.null_count() > 0) {
+      ARROW_ASSIGN_OR_RAISE(null_bitmap, arrow::internal::CopyBitmap(default_memory_pool(),
+                                                                     input.null_bitmap_data(),
+                                                                     input.offset(), length));
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto offsets, offsets_builder.Finish());
+    auto data = Buffer::FromString(std::move(data_));
+    return std::make_shared<StringArray>(length, offsets, data, null_bitmap, input.null_count());
+  }
+};
 }
 
 namespace driver {
@@ -290,20 +488,8 @@ std::string ConvertToJson(const arrow::Scalar &scalar) {
 }
 
 arrow::Result<std::shared_ptr<arrow::Array>> ConvertToJson(const std::shared_ptr<arrow::Array>& input) {
-  arrow::StringBuilder builder;
-  int64_t length = input->length();
-  RETURN_NOT_OK(builder.ReserveData(length));
-
-  for (int64_t i = 0; i < length; ++i) {
-    if (input->IsNull(i)) {
-      RETURN_NOT_OK(builder.AppendNull());
-    } else {
-      ARROW_ASSIGN_OR_RAISE(auto scalar, input->GetScalar(i))
-      RETURN_NOT_OK(builder.Append(ConvertToJson(*scalar)));
-    }
-  }
-  
-  return builder.Finish();
+  ArrayToJson converter;
+  return converter.Convert(*input);
 }
 
 }
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "json_converter.h"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/scalar.h>
+#include <benchmark/benchmark.h>
+
+#include "utils.h"
+
+namespace driver {
+namespace flight_sql {
+
+using namespace arrow;
+
+namespace {
+
+constexpr int64_t kRows = 4096;
+
+std::shared_ptr<Array> MakeLeafArray(int64_t length, int64_t seed) {
+  Int64Builder builder;
+  ThrowIfNotOK(builder.Reserve(length));
+  for (int64_t i = 0; i < length; ++i) {
+    builder.UnsafeAppend(i * 31 + seed);
+  }
+  return builder.Finish().ValueOrDie();
+}
+
+/// Struct with `width` int64 fields per row.
+std::shared_ptr<Array> MakeWideStruct(int64_t length, int width) {
+  ArrayVector children;
+  std::vector<std::string> names;
+  for (int i = 0; i < width; ++i) {
+    children.push_back(MakeLeafArray(length, i));
+    names.push_back("field_" + std::to_string(i));
+  }
+  return StructArray::Make(children, names).ValueOrDie();
+}
+
+/// `depth` levels of list<struct<value, list<...>>>, with three elements per list.
+std::shared_ptr<Array> MakeDeepList(int64_t length, int depth) {
+  int64_t leaf_length = length;
+  for (int i = 0; i < depth; ++i) {
+    leaf_length *= 3;
+  }
+
+  std::shared_ptr<Array> current = MakeLeafArray(leaf_length, 0);
+  for (int i = 0; i < depth; ++i) {
+    const int64_t list_length = current->length() / 3;
+    Int32Builder offsets_builder;
+    ThrowIfNotOK(offsets_builder.Reserve(list_length + 1));
+    for (int64_t j = 0; j <= list_length; ++j) {
+      offsets_builder.UnsafeAppend(static_cast<int32_t>(j * 3));
+    }
+    auto offsets = offsets_builder.Finish().ValueOrDie();
+    auto list = ListArray::FromArrays(*offsets, *current).ValueOrDie();
+    current = StructArray::Make({MakeLeafArray(list_length, i), list}, {"value", "children"}).ValueOrDie();
+  }
+  return current;
+}
+
+/// The converter that walked every row and nested element through a Scalar.
+std::shared_ptr<Array> ConvertToJsonThroughScalars(const std::shared_ptr<Array> &input) {
+  StringBuilder builder;
+  for (int64_t i = 0; i < input->length(); ++i) {
+    if (input->IsNull(i)) {
+      ThrowIfNotOK(builder.AppendNull());
+    } else {
+      ThrowIfNotOK(builder.Append(ConvertToJson(*input->GetScalar(i).ValueOrDie())));
+    }
+  }
+  return builder.Finish().ValueOrDie();
+}
+
+void BM_ScalarConverter_WideStruct(benchmark::State &state) {
+  auto array = MakeWideStruct(kRows, static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ConvertToJsonThroughScalars(array));
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+
+void BM_ArrayConverter_WideStruct(benchmark::State &state) {
+  auto array = MakeWideStruct(kRows, static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ConvertToJson(array).ValueOrDie());
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+
+void BM_ScalarConverter_DeepList(benchmark::State &state) {
+  auto array = MakeDeepList(kRows / 64, static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ConvertToJsonThroughScalars(array));
+  }
+  state.SetItemsProcessed(state.iterations() * array->length());
+}
+
+void BM_ArrayConverter_DeepList(benchmark::State &state) {
+  auto array = MakeDeepList(kRows / 64, static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ConvertToJson(array).ValueOrDie());
+  }
+  state.SetItemsProcessed(state.iterations() * array->length());
+}
+
+} // namespace
+
+BENCHMARK(BM_ScalarConverter_WideStruct)->Arg(4)->Arg(40);
+BENCHMARK(BM_ArrayConverter_WideStruct)->Arg(4)->Arg(40);
+BENCHMARK(BM_ScalarConverter_DeepList)->Arg(2)->Arg(5);
+BENCHMARK(BM_ArrayConverter_DeepList)->Arg(2)->Arg(5);
+
+} // namespace flight_sql
+} // namespace driver
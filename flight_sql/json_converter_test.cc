@@ -8,6 +8,8 @@
 
 #include "gtest/gtest.h"
 #include "arrow/testing/builder.h"
+#include "arrow/testing/gtest_util.h"
+#include <arrow/util/checked_cast.h>
 #include <arrow/scalar.h>
 #include <arrow/type.h>
 
@@ -15,6 +17,7 @@ namespace driver {
 namespace flight_sql {
 
 using namespace arrow;
+using arrow::internal::checked_cast;
 
 TEST(ConvertToJson, String) {
   ASSERT_EQ("\"\"", ConvertToJson(StringScalar("")));
@@ -183,5 +186,52 @@ TEST(ConvertToJson, Struct) {
   ASSERT_EQ("{\"i\":1,\"f\":2.5,\"s\":\"yo\",\"null\":null}", ConvertToJson(*scalar));
 }
 
+TEST(ConvertToJson, NestedArrayMatchesScalarConversion) {
+  std::shared_ptr<Array> ids;
+  ArrayFromVector<Int32Type, int32_t>({true, true, false, true}, {1, 0, 0, 4}, &ids);
+
+  std::shared_ptr<Array> tag_offsets, tag_values;
+  ArrayFromVector<Int32Type, int32_t>({0, 2, 2, 3, 3}, &tag_offsets);
+  ArrayFromVector<StringType, std::string>({true, true, false}, {"a", "b", ""}, &tag_values);
+  ASSERT_OK_AND_ASSIGN(auto tags, ListArray::FromArrays(*tag_offsets, *tag_values));
+
+  std::shared_ptr<Array> attr_offsets, attr_keys, attr_items;
+  ArrayFromVector<Int32Type, int32_t>({0, 1, 1, 1, 3}, &attr_offsets);
+  ArrayFromVector<StringType, std::string>({"x", "y", "z"}, &attr_keys);
+  ArrayFromVector<Int64Type, int64_t>({true, true, false}, {1, 2, 0}, &attr_items);
+  ASSERT_OK_AND_ASSIGN(auto attrs, MapArray::FromArrays(attr_offsets, attr_keys, attr_items));
+
+  std::shared_ptr<Array> point_values;
+  ArrayFromVector<DoubleType, double>({1.5, 2.5, 0, 0, 0, 0, 0, -1}, &point_values);
+  ASSERT_OK_AND_ASSIGN(auto points, FixedSizeListArray::FromArrays(point_values, 2));
+
+  std::shared_ptr<Array> inner_binary, inner_dates;
+  ArrayFromVector<BinaryType, std::string>({true, true, true, false}, {"foo", "", "\x01", ""}, &inner_binary);
+  ArrayFromVector<Date32Type, int32_t>({0, 0, 0, 1}, &inner_dates);
+  ASSERT_OK_AND_ASSIGN(auto inner, StructArray::Make({inner_binary, inner_dates}, {"b", "d"}));
+
+  // Borrow the validity bitmap of a helper array to make the second row null.
+  std::shared_ptr<Array> validity;
+  ArrayFromVector<Int8Type, int8_t>({true, false, true, true}, {0, 0, 0, 0}, &validity);
+  ASSERT_OK_AND_ASSIGN(auto array, StructArray::Make({ids, tags, attrs, points, inner},
+                                                     {"id", "tags", "attrs", "point", "inner"},
+                                                     validity->null_bitmap(), 1));
+
+  for (int64_t offset = 0; offset < 2; ++offset) {
+    auto sliced = array->Slice(offset);
+    ASSERT_OK_AND_ASSIGN(auto result, ConvertToJson(sliced));
+    const auto &json_array = checked_cast<const StringArray &>(*result);
+
+    ASSERT_EQ(sliced->length(), json_array.length());
+    for (int64_t i = 0; i < sliced->length(); ++i) {
+      ASSERT_EQ(sliced->IsNull(i), json_array.IsNull(i));
+      if (!sliced->IsNull(i)) {
+        ASSERT_OK_AND_ASSIGN(auto scalar, sliced->GetScalar(i));
+        ASSERT_EQ(ConvertToJson(*scalar), json_array.GetString(i));
+      }
+    }
+  }
+}
+
 } // namespace flight_sql
 } // namespace driver
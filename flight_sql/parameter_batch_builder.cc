@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "parameter_batch_builder.h"
+
+#include <odbcabstraction/platform.h>
+#include <odbcabstraction/encoding.h>
+#include <odbcabstraction/exceptions.h>
+#include <odbcabstraction/types.h>
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/builder.h>
+#include <arrow/compute/api.h>
+#include <arrow/type_traits.h>
+#include <sql.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "utils.h"
+
+namespace driver {
+namespace flight_sql {
+
+using arrow::Array;
+using arrow::RecordBatch;
+using odbcabstraction::CDataType;
+using odbcabstraction::DriverException;
+using odbcabstraction::ParameterBinding;
+
+namespace {
+
+struct BindingLayout {
+  size_t bind_offset;
+  size_t bind_type;
+  size_t first_row;
+};
+
+/// Locates the values and indicators of each parameter set within the bound
+/// buffers.
+class ParameterReader {
+public:
+  ParameterReader(const ParameterBinding &binding, size_t element_size,
+                  const BindingLayout &layout)
+      : value_stride_(layout.bind_type ? layout.bind_type : element_size),
+        indicator_stride_(layout.bind_type ? layout.bind_type : sizeof(ssize_t)) {
+    values_ = static_cast<const uint8_t *>(binding.buffer) + layout.bind_offset +
+              layout.first_row * value_stride_;
+    indicators_ = binding.strlen_buffer
+                      ? reinterpret_cast<const uint8_t *>(binding.strlen_buffer) +
+                            layout.bind_offset + layout.first_row * indicator_stride_
+                      : nullptr;
+  }
+
+  const uint8_t *Value(size_t row) const {
+    return values_ + row * value_stride_;
+  }
+
+  /// Returns the length or null indicator of the row. Without indicators,
+  /// values are taken as non-null and null terminated.
+  ssize_t Indicator(size_t row) const {
+    if (!indicators_) {
+      return SQL_NTS;
+    }
+
+    ssize_t indicator;
+    memcpy(&indicator, indicators_ + row * indicator_stride_, sizeof(ssize_t));
+    if (indicator < 0 && indicator != odbcabstraction::NULL_DATA && indicator != SQL_NTS) {
+      throw DriverException("Data-at-execution and default parameters are not supported", "HYC00");
+    }
+    return indicator;
+  }
+
+  bool HasIndicators() const {
+    return indicators_ != nullptr;
+  }
+
+  bool IsContiguous(size_t element_size) const {
+    return value_stride_ == element_size;
+  }
+
+  const uint8_t *values() const {
+    return values_;
+  }
+
+private:
+  const uint8_t *values_;
+  const uint8_t *indicators_;
+  size_t value_stride_;
+  size_t indicator_stride_;
+};
+
+/// Builds the validity bitmap from the indicators. Returns null when there
+/// are no nulls.
+std::shared_ptr<arrow::Buffer> MakeValidityBitmap(const ParameterReader &reader,
+                                                  size_t rows, int64_t *null_count) {
+  *null_count = 0;
+  if (!reader.HasIndicators()) {
+    return nullptr;
+  }
+
+  std::shared_ptr<arrow::Buffer> bitmap;
+  for (size_t i = 0; i < rows; ++i) {
+    if (reader.Indicator(i) != odbcabstraction::NULL_DATA) {
+      continue;
+    }
+
+    if (!bitmap) {
+      auto result = arrow::AllocateBuffer((rows + 7) / 8);
+      ThrowIfNotOK(result.status());
+      bitmap = std::move(result).ValueOrDie();
+      memset(bitmap->mutable_data(), 0xFF, bitmap->size());
+    }
+    bitmap->mutable_data()[i / 8] &= static_cast<uint8_t>(~(1 << (i % 8)));
+    ++*null_count;
+  }
+  return bitmap;
+}
+
+template <typename ARROW_TYPE>
+std::shared_ptr<Array> MakeFixedWidthArray(const ParameterBinding &binding, size_t rows,
+                                           const BindingLayout &layout) {
+  typedef typename ARROW_TYPE::c_type c_type;
+  ParameterReader reader(binding, sizeof(c_type), layout);
+
+  int64_t null_count;
+  std::shared_ptr<arrow::Buffer> validity = MakeValidityBitmap(reader, rows, &null_count);
+
+  std::shared_ptr<arrow::Buffer> data;
+  if (reader.IsContiguous(sizeof(c_type)) &&
+      reinterpret_cast<uintptr_t>(reader.values()) % alignof(c_type) == 0) {
+    // Column-wise values already have Arrow's layout.
+    data = std::make_shared<arrow::Buffer>(reader.values(), rows * sizeof(c_type));
+  } else {
+    auto result = arrow::AllocateBuffer(rows * sizeof(c_type));
+    ThrowIfNotOK(result.status());
+    std::shared_ptr<arrow::Buffer> buffer = std::move(result).ValueOrDie();
+    for (size_t i = 0; i < rows; ++i) {
+      memcpy(buffer->mutable_data() + i * sizeof(c_type), reader.Value(i), sizeof(c_type));
+    }
+    data = std::move(buffer);
+  }
+
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      arrow::TypeTraits<ARROW_TYPE>::type_singleton(), static_cast<int64_t>(rows),
+      {validity, data}, null_count));
+}
+
+/// Appends each row through `append`, or a null when the indicator says so.
+template <typename BUILDER>
+std::shared_ptr<Array> BuildArray(BUILDER &builder, const ParameterReader &reader, size_t rows,
+                                  const std::function<void(const uint8_t *, ssize_t)> &append) {
+  ThrowIfNotOK(builder.Reserve(static_cast<int64_t>(rows)));
+  for (size_t i = 0; i < rows; ++i) {
+    ssize_t indicator = reader.Indicator(i);
+    if (indicator == odbcabstraction::NULL_DATA) {
+      ThrowIfNotOK(builder.AppendNull());
+    } else {
+      append(reader.Value(i), indicator);
+    }
+  }
+
+  std::shared_ptr<Array> array;
+  ThrowIfNotOK(builder.Finish(&array));
+  return array;
+}
+
+/// Days since 1970-01-01 of a proleptic Gregorian date.
+int32_t DaysFromCivil(int32_t year, uint32_t month, uint32_t day) {
+  year -= month <= 2;
+  const int32_t era = (year >= 0 ? year : year - 399) / 400;
+  const uint32_t year_of_era = static_cast<uint32_t>(year - era * 400);
+  const uint32_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const uint32_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + static_cast<int32_t>(day_of_era) - 719468;
+}
+
+std::shared_ptr<Array> MakeParameterArray(const ParameterBinding &binding, size_t rows,
+                                          const BindingLayout &layout) {
+  const CDataType c_type = ConvertCDataTypeFromV2ToV3(binding.c_type);
+  switch (c_type) {
+    case odbcabstraction::CDataType_STINYINT:
+      return MakeFixedWidthArray<arrow::Int8Type>(binding, rows, layout);
+    case odbcabstraction::CDataType_UTINYINT:
+      return MakeFixedWidthArray<arrow::UInt8Type>(binding, rows, layout);
+    case odbcabstraction::CDataType_SSHORT:
+      return MakeFixedWidthArray<arrow::Int16Type>(binding, rows, layout);
+    case odbcabstraction::CDataType_USHORT:
+      return MakeFixedWidthArray<arrow::UInt16Type>(binding, rows, layout);
+    case odbcabstraction::CDataType_SLONG:
+      return MakeFixedWidthArray<arrow::Int32Type>(binding, rows, layout);
+    case odbcabstraction::CDataType_ULONG:
+      return MakeFixedWidthArray<arrow::UInt32Type>(binding, rows, layout);
+    case odbcabstraction::CDataType_SBIGINT:
+      return MakeFixedWidthArray<arrow::Int64Type>(binding, rows, layout);
+    case odbcabstraction::CDataType_UBIGINT:
+      return MakeFixedWidthArray<arrow::UInt64Type>(binding, rows, layout);
+    case odbcabstraction::CDataType_FLOAT:
+      return MakeFixedWidthArray<arrow::FloatType>(binding, rows, layout);
+    case odbcabstraction::CDataType_DOUBLE:
+      return MakeFixedWidthArray<arrow::DoubleType>(binding, rows, layout);
+    case odbcabstraction::CDataType_BIT: {
+      arrow::BooleanBuilder builder;
+      return BuildArray(builder, ParameterReader(binding, sizeof(uint8_t), layout), rows,
+                        [&builder](const uint8_t *value, ssize_t) {
+                          builder.UnsafeAppend(*value != 0);
+                        });
+    }
+    case odbcabstraction::CDataType_CHAR: {
+      arrow::StringBuilder builder;
+      return BuildArray(builder, ParameterReader(binding, binding.buffer_length, layout), rows,
+                        [&builder](const uint8_t *value, ssize_t length) {
+                          const char *chars = reinterpret_cast<const char *>(value);
+                          ThrowIfNotOK(builder.Append(chars, static_cast<int32_t>(
+                              length == SQL_NTS ? strlen(chars) : length)));
+                        });
+    }
+    case odbcabstraction::CDataType_WCHAR: {
+      arrow::StringBuilder builder;
+      std::vector<uint8_t> utf8;
+      return BuildArray(builder, ParameterReader(binding, binding.buffer_length, layout), rows,
+                        [&builder, &utf8](const uint8_t *value, ssize_t length) {
+                          if (length == SQL_NTS) {
+                            odbcabstraction::WcsToUtf8(value, &utf8);
+                          } else {
+                            odbcabstraction::WcsToUtf8(value, length / odbcabstraction::GetSqlWCharSize(), &utf8);
+                          }
+                          ThrowIfNotOK(builder.Append(utf8.data(), static_cast<int32_t>(utf8.size())));
+                        });
+    }
+    case odbcabstraction::CDataType_BINARY: {
+      arrow::BinaryBuilder builder;
+      const ssize_t buffer_length = binding.buffer_length;
+      return BuildArray(builder, ParameterReader(binding, binding.buffer_length, layout), rows,
+                        [&builder, buffer_length](const uint8_t *value, ssize_t length) {
+                          ThrowIfNotOK(builder.Append(value, static_cast<int32_t>(
+                              length == SQL_NTS ? buffer_length : length)));
+                        });
+    }
+    case odbcabstraction::CDataType_DATE: {
+      arrow::Date32Builder builder;
+      return BuildArray(builder, ParameterReader(binding, sizeof(odbcabstraction::DATE_STRUCT), layout), rows,
+                        [&builder](const uint8_t *value, ssize_t) {
+                          odbcabstraction::DATE_STRUCT date;
+                          memcpy(&date, value, sizeof(date));
+                          builder.UnsafeAppend(DaysFromCivil(date.year, date.month, date.day));
+                        });
+    }
+    case odbcabstraction::CDataType_TIME: {
+      arrow::Time32Builder builder(arrow::time32(arrow::TimeUnit::SECOND), arrow::default_memory_pool());
+      return BuildArray(builder, ParameterReader(binding, sizeof(odbcabstraction::TIME_STRUCT), layout), rows,
+                        [&builder](const uint8_t *value, ssize_t) {
+                          odbcabstraction::TIME_STRUCT time;
+                          memcpy(&time, value, sizeof(time));
+                          builder.UnsafeAppend(time.hour * 3600 + time.minute * 60 + time.second);
+                        });
+    }
+    case odbcabstraction::CDataType_TIMESTAMP: {
+      arrow::TimestampBuilder builder(arrow::timestamp(arrow::TimeUnit::MICRO), arrow::default_memory_pool());
+      return BuildArray(builder, ParameterReader(binding, sizeof(odbcabstraction::TIMESTAMP_STRUCT), layout), rows,
+                        [&builder](const uint8_t *value, ssize_t) {
+                          odbcabstraction::TIMESTAMP_STRUCT timestamp;
+                          memcpy(&timestamp, value, sizeof(timestamp));
+                          int64_t seconds = static_cast<int64_t>(DaysFromCivil(timestamp.year, timestamp.month, timestamp.day)) *
+                                                odbcabstraction::DAYS_TO_SECONDS_MULTIPLIER +
+                                            timestamp.hour * 3600 + timestamp.minute * 60 + timestamp.second;
+                          // The fraction is in nanoseconds.
+                          builder.UnsafeAppend(seconds * odbcabstraction::MICRO_TO_SECONDS_DIVISOR +
+                                               timestamp.fraction / 1000);
+                        });
+    }
+    case odbcabstraction::CDataType_NUMERIC: {
+      const int32_t precision = binding.precision > 0 ? binding.precision : arrow::Decimal128Type::kMaxPrecision;
+      arrow::Decimal128Builder builder(arrow::decimal128(precision, binding.scale), arrow::default_memory_pool());
+      return BuildArray(builder, ParameterReader(binding, sizeof(odbcabstraction::NUMERIC_STRUCT), layout), rows,
+                        [&builder](const uint8_t *value, ssize_t) {
+                          odbcabstraction::NUMERIC_STRUCT numeric;
+                          memcpy(&numeric, value, sizeof(numeric));
+                          // The struct holds the magnitude, with sign 1 for positive values.
+                          arrow::Decimal128 decimal(numeric.val);
+                          if (numeric.sign == 0) {
+                            decimal.Negate();
+                          }
+                          builder.UnsafeAppend(decimal);
+                        });
+    }
+    default:
+      throw DriverException("Unsupported parameter C type: " + std::to_string(binding.c_type), "HYC00");
+  }
+}
+
+} // namespace
+
+std::shared_ptr<RecordBatch>
+BuildParameterBatch(const std::shared_ptr<arrow::Schema> &parameter_schema,
+                    const std::vector<ParameterBinding> &bindings,
+                    size_t paramset_size, size_t bind_offset, size_t bind_type,
+                    size_t first_paramset) {
+  // Servers may not describe parameters, in which case types come from the bindings.
+  const bool use_schema = parameter_schema && parameter_schema->num_fields() > 0;
+  if (use_schema && static_cast<size_t>(parameter_schema->num_fields()) != bindings.size()) {
+    throw DriverException("The statement expects " + std::to_string(parameter_schema->num_fields()) +
+                          " parameters but " + std::to_string(bindings.size()) + " were bound", "07002");
+  }
+
+  const size_t rows = std::max(paramset_size, static_cast<size_t>(1));
+  const BindingLayout layout = {bind_offset, bind_type, first_paramset};
+
+  arrow::FieldVector fields;
+  arrow::ArrayVector arrays;
+  for (size_t i = 0; i < bindings.size(); ++i) {
+    std::shared_ptr<Array> array = MakeParameterArray(bindings[i], rows, layout);
+
+    if (use_schema) {
+      const std::shared_ptr<arrow::Field> &field = parameter_schema->field(static_cast<int>(i));
+      if (!array->type()->Equals(field->type())) {
+        arrow::compute::CastOptions cast_options;
+        cast_options.to_type = field->type();
+        array = CheckConversion(arrow::compute::CallFunction("cast", {array}, &cast_options));
+      }
+      fields.push_back(field);
+    } else {
+      fields.push_back(arrow::field("parameter_" + std::to_string(i + 1), array->type()));
+    }
+    arrays.push_back(std::move(array));
+  }
+
+  return RecordBatch::Make(arrow::schema(fields), static_cast<int64_t>(rows), arrays);
+}
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#pragma once
+
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <odbcabstraction/spi/statement.h>
+
+#include <memory>
+#include <vector>
+
+namespace driver {
+namespace flight_sql {
+
+/// \brief Builds the record batch sent as the parameters of a prepared
+/// statement, holding one row per parameter set.
+///
+/// Columns take the types of `parameter_schema` when the server reports one,
+/// otherwise the Arrow type matching each C type. Fixed-width values bound
+/// column-wise are referenced in place rather than copied, so the batch must
+/// not outlive the bound buffers.
+///
+/// \param parameter_schema The parameter schema of the prepared statement.
+///                         May be null or empty.
+/// \param bindings The buffers bound to each parameter.
+/// \param paramset_size The number of parameter sets.
+/// \param bind_offset The offset for bound buffers and indicators.
+/// \param bind_type Zero for column-wise binding, otherwise the size of an
+///                  application row buffer.
+/// \param first_paramset The first parameter set to include, so large arrays
+///                       can be sent in several batches.
+std::shared_ptr<arrow::RecordBatch>
+BuildParameterBatch(const std::shared_ptr<arrow::Schema> &parameter_schema,
+                    const std::vector<odbcabstraction::ParameterBinding> &bindings,
+                    size_t paramset_size, size_t bind_offset, size_t bind_type,
+                    size_t first_paramset = 0);
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include <odbcabstraction/platform.h>
+#include "parameter_batch_builder.h"
+
+#include <odbcabstraction/exceptions.h>
+#include <odbcabstraction/types.h>
+
+#include <arrow/array.h>
+#include <sql.h>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace driver {
+namespace flight_sql {
+
+using namespace arrow;
+using odbcabstraction::ParameterBinding;
+
+TEST(ParameterBatchBuilder, ColumnWiseIntegersAreNotCopied) {
+  std::vector<int32_t> values = {1, 2, 3};
+  std::vector<ssize_t> indicators = {sizeof(int32_t), odbcabstraction::NULL_DATA, sizeof(int32_t)};
+  std::vector<ParameterBinding> bindings = {
+      {odbcabstraction::CDataType_SLONG, 0, 0, values.data(), 0, indicators.data()}};
+
+  auto batch = BuildParameterBatch(nullptr, bindings, values.size(), 0, 0);
+
+  ASSERT_EQ(3, batch->num_rows());
+  ASSERT_EQ(1, batch->num_columns());
+  ASSERT_TRUE(batch->column(0)->type()->Equals(int32()));
+  ASSERT_EQ("parameter_1", batch->schema()->field(0)->name());
+
+  auto array = std::static_pointer_cast<Int32Array>(batch->column(0));
+  ASSERT_EQ(reinterpret_cast<const uint8_t *>(values.data()), array->values()->data());
+  ASSERT_EQ(1, array->Value(0));
+  ASSERT_TRUE(array->IsNull(1));
+  ASSERT_EQ(3, array->Value(2));
+}
+
+TEST(ParameterBatchBuilder, StartsAtGivenParameterSet) {
+  std::vector<int32_t> values = {1, 2, 3, 4};
+  std::vector<ssize_t> indicators = {sizeof(int32_t), sizeof(int32_t), odbcabstraction::NULL_DATA, sizeof(int32_t)};
+  std::vector<ParameterBinding> bindings = {
+      {odbcabstraction::CDataType_SLONG, 0, 0, values.data(), 0, indicators.data()}};
+
+  auto batch = BuildParameterBatch(nullptr, bindings, 2, 0, 0, 1);
+
+  ASSERT_EQ(2, batch->num_rows());
+  auto array = std::static_pointer_cast<Int32Array>(batch->column(0));
+  ASSERT_EQ(2, array->Value(0));
+  ASSERT_TRUE(array->IsNull(1));
+}
+
+TEST(ParameterBatchBuilder, RowWiseBinding) {
+  struct Row {
+    int64_t id;
+    ssize_t id_indicator;
+    char name[8];
+    ssize_t name_indicator;
+  };
+  std::vector<Row> rows(2);
+  rows[0].id = 10;
+  rows[0].id_indicator = sizeof(int64_t);
+  strcpy(rows[0].name, "foo");
+  rows[0].name_indicator = SQL_NTS;
+  rows[1].id = 20;
+  rows[1].id_indicator = sizeof(int64_t);
+  strcpy(rows[1].name, "barbaz");
+  rows[1].name_indicator = 3;
+
+  std::vector<ParameterBinding> bindings = {
+      {odbcabstraction::CDataType_SBIGINT, 0, 0, &rows[0].id, 0, &rows[0].id_indicator},
+      {odbcabstraction::CDataType_CHAR, 0, 0, rows[0].name, sizeof(rows[0].name), &rows[0].name_indicator}};
+
+  auto batch = BuildParameterBatch(nullptr, bindings, rows.size(), 0, sizeof(Row));
+
+  ASSERT_EQ(2, batch->num_rows());
+  auto ids = std::static_pointer_cast<Int64Array>(batch->column(0));
+  ASSERT_EQ(10, ids->Value(0));
+  ASSERT_EQ(20, ids->Value(1));
+  auto names = std::static_pointer_cast<StringArray>(batch->column(1));
+  ASSERT_EQ("foo", names->GetString(0));
+  ASSERT_EQ("bar", names->GetString(1));
+}
+
+TEST(ParameterBatchBuilder, CastsToParameterSchema) {
+  std::vector<int32_t> values = {7, 8};
+  std::vector<ParameterBinding> bindings = {
+      {odbcabstraction::CDataType_SLONG, 0, 0, values.data(), 0, nullptr}};
+  auto schema = arrow::schema({field("id", int64())});
+
+  auto batch = BuildParameterBatch(schema, bindings, values.size(), 0, 0);
+
+  ASSERT_TRUE(batch->schema()->Equals(*schema));
+  auto array = std::static_pointer_cast<Int64Array>(batch->column(0));
+  ASSERT_EQ(7, array->Value(0));
+  ASSERT_EQ(8, array->Value(1));
+}
+
+TEST(ParameterBatchBuilder, RejectsWrongParameterCount) {
+  std::vector<int32_t> values = {7};
+  std::vector<ParameterBinding> bindings = {
+      {odbcabstraction::CDataType_SLONG, 0, 0, values.data(), 0, nullptr}};
+  auto schema = arrow::schema({field("id", int64()), field("name", utf8())});
+
+  ASSERT_THROW(BuildParameterBatch(schema, bindings, 1, 0, 0), odbcabstraction::DriverException);
+}
+
+} // namespace flight_sql
+} // namespace driver
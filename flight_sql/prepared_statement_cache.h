@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#pragma once
+
+#include <arrow/flight/sql/client.h>
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace driver {
+namespace flight_sql {
+
+/// \brief A least-recently-used cache of server handles keyed by query, shared
+/// by the statements of a connection.
+///
+/// A handle is used by one statement at a time: Acquire() takes it out of the
+/// cache and Release() puts it back, closing whichever handle no longer fits.
+/// The cache also counts direct executions of each query so frequent ones can
+/// be promoted to prepared execution.
+template <typename Handle>
+class HandleCache {
+public:
+  typedef std::function<void(const std::shared_ptr<Handle> &)> Closer;
+
+  /// \param capacity The maximum number of cached handles.
+  /// \param promotion_threshold The number of direct executions of a query
+  ///                            after which it is promoted. Zero disables
+  ///                            promotion.
+  /// \param closer Closes the handles evicted from the cache.
+  HandleCache(size_t capacity, size_t promotion_threshold, Closer closer)
+      : capacity_(capacity), promotion_threshold_(promotion_threshold),
+        closer_(std::move(closer)) {}
+
+  ~HandleCache() { Clear(); }
+
+  /// \brief Takes the handle cached for the key, or returns null if there is
+  /// none.
+  std::shared_ptr<Handle> Acquire(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+
+    std::shared_ptr<Handle> handle = std::move(it->second->second);
+    entries_.erase(it->second);
+    index_.erase(it);
+    return handle;
+  }
+
+  /// \brief Returns a handle to the cache as the most recently used one.
+  void Release(const std::string &key, std::shared_ptr<Handle> handle) {
+    std::shared_ptr<Handle> evicted;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (capacity_ == 0 || index_.count(key)) {
+        // Another statement already returned a handle for the same query.
+        evicted = std::move(handle);
+      } else {
+        entries_.emplace_front(key, std::move(handle));
+        index_[key] = entries_.begin();
+        if (entries_.size() > capacity_) {
+          evicted = std::move(entries_.back().second);
+          index_.erase(entries_.back().first);
+          entries_.pop_back();
+        }
+      }
+    }
+
+    // Closing may call the server, so it happens without the lock.
+    if (evicted) {
+      closer_(evicted);
+    }
+  }
+
+  /// \brief Counts a direct execution of the key. Returns true if the query
+  /// has been executed often enough to be promoted.
+  bool RecordDirectExecution(const std::string &key) {
+    if (promotion_threshold_ == 0) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (execution_counts_.size() >= MAX_TRACKED_QUERIES && !execution_counts_.count(key)) {
+      // Bounds the memory used on workloads that never repeat a query.
+      execution_counts_.clear();
+    }
+    return ++execution_counts_[key] >= promotion_threshold_;
+  }
+
+  /// \brief Closes and removes every cached handle.
+  void Clear() {
+    std::list<std::pair<std::string, std::shared_ptr<Handle>>> entries;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      entries.swap(entries_);
+      index_.clear();
+      execution_counts_.clear();
+    }
+
+    for (const auto &entry : entries) {
+      closer_(entry.second);
+    }
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+private:
+  typedef std::list<std::pair<std::string, std::shared_ptr<Handle>>> EntryList;
+
+  static const size_t MAX_TRACKED_QUERIES = 1024;
+
+  const size_t capacity_;
+  const size_t promotion_threshold_;
+  const Closer closer_;
+  std::mutex mutex_;
+  EntryList entries_; // Most recently used first.
+  std::unordered_map<std::string, typename EntryList::iterator> index_;
+  std::unordered_map<std::string, size_t> execution_counts_;
+};
+
+typedef HandleCache<arrow::flight::sql::PreparedStatement> PreparedStatementCache;
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "prepared_statement_cache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace driver {
+namespace flight_sql {
+
+namespace {
+class HandleCacheTest : public ::testing::Test {
+protected:
+  std::vector<int> closed_;
+
+  HandleCache<int>::Closer Closer() {
+    return [this](const std::shared_ptr<int> &handle) { closed_.push_back(*handle); };
+  }
+};
+} // namespace
+
+TEST_F(HandleCacheTest, AcquireTakesHandleOut) {
+  HandleCache<int> cache(2, 0, Closer());
+  cache.Release("a", std::make_shared<int>(1));
+
+  auto handle = cache.Acquire("a");
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(1, *handle);
+  ASSERT_EQ(nullptr, cache.Acquire("a"));
+  ASSERT_EQ(nullptr, cache.Acquire("b"));
+  ASSERT_TRUE(closed_.empty());
+}
+
+TEST_F(HandleCacheTest, EvictsLeastRecentlyUsed) {
+  HandleCache<int> cache(2, 0, Closer());
+  cache.Release("a", std::make_shared<int>(1));
+  cache.Release("b", std::make_shared<int>(2));
+
+  // Using "a" makes "b" the least recently used.
+  cache.Release("a", cache.Acquire("a"));
+  cache.Release("c", std::make_shared<int>(3));
+
+  ASSERT_EQ(std::vector<int>({2}), closed_);
+  ASSERT_EQ(2, cache.size());
+  ASSERT_EQ(nullptr, cache.Acquire("b"));
+  ASSERT_NE(nullptr, cache.Acquire("a"));
+  ASSERT_NE(nullptr, cache.Acquire("c"));
+}
+
+TEST_F(HandleCacheTest, ClosesDuplicateHandles) {
+  HandleCache<int> cache(2, 0, Closer());
+  cache.Release("a", std::make_shared<int>(1));
+  cache.Release("a", std::make_shared<int>(2));
+
+  ASSERT_EQ(std::vector<int>({2}), closed_);
+  ASSERT_EQ(1, *cache.Acquire("a"));
+}
+
+TEST_F(HandleCacheTest, ClearClosesEverything) {
+  HandleCache<int> cache(2, 0, Closer());
+  cache.Release("a", std::make_shared<int>(1));
+  cache.Release("b", std::make_shared<int>(2));
+  cache.Clear();
+
+  ASSERT_EQ(2, closed_.size());
+  ASSERT_EQ(0, cache.size());
+}
+
+TEST_F(HandleCacheTest, PromotesAfterThreshold) {
+  HandleCache<int> cache(2, 3, Closer());
+
+  ASSERT_FALSE(cache.RecordDirectExecution("SELECT 1"));
+  ASSERT_FALSE(cache.RecordDirectExecution("SELECT 1"));
+  ASSERT_FALSE(cache.RecordDirectExecution("SELECT 2"));
+  ASSERT_TRUE(cache.RecordDirectExecution("SELECT 1"));
+}
+
+TEST_F(HandleCacheTest, PromotionDisabledByDefault) {
+  HandleCache<int> cache(2, 0, Closer());
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_FALSE(cache.RecordDirectExecution("SELECT 1"));
+  }
+}
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "record_batch_spool.h"
+
+#include <arrow/ipc/message.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <odbcabstraction/exceptions.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "utils.h"
+
+namespace driver {
+namespace flight_sql {
+
+using arrow::RecordBatch;
+using arrow::Schema;
+using arrow::internal::TemporaryDir;
+using arrow::io::FileOutputStream;
+using arrow::io::MemoryMappedFile;
+using odbcabstraction::DriverException;
+
+std::unique_ptr<RecordBatchSpool>
+RecordBatchSpool::Make(std::shared_ptr<Schema> schema,
+                       const arrow::ipc::IpcWriteOptions &options) {
+  arrow::Result<std::unique_ptr<TemporaryDir>> temp_dir = TemporaryDir::Make("flightsql-odbc-");
+  ThrowIfNotOK(temp_dir.status());
+
+  arrow::Result<arrow::internal::PlatformFilename> path =
+      temp_dir.ValueOrDie()->path().Join("results.arrow");
+  ThrowIfNotOK(path.status());
+
+  arrow::Result<std::shared_ptr<FileOutputStream>> file =
+      FileOutputStream::Open(path.ValueOrDie().ToString());
+  ThrowIfNotOK(file.status());
+
+  return std::unique_ptr<RecordBatchSpool>(new RecordBatchSpool(
+      std::move(temp_dir).ValueOrDie(), path.ValueOrDie().ToString(),
+      std::move(file).ValueOrDie(), std::move(schema), options));
+}
+
+RecordBatchSpool::RecordBatchSpool(std::unique_ptr<TemporaryDir> temp_dir,
+                                   std::string path,
+                                   std::shared_ptr<FileOutputStream> file,
+                                   std::shared_ptr<Schema> schema,
+                                   const arrow::ipc::IpcWriteOptions &options)
+    : temp_dir_(std::move(temp_dir)), path_(std::move(path)),
+      file_(std::move(file)), mapped_size_(0), schema_(std::move(schema)),
+      options_(options), batch_offsets_(1, 0), file_size_(0) {}
+
+void RecordBatchSpool::Append(const RecordBatch &batch) {
+  Block block = {file_size_, 0, 0};
+  ThrowIfNotOK(arrow::ipc::WriteRecordBatch(batch, 0, file_.get(), &block.metadata_length,
+                                            &block.body_length, options_));
+
+  blocks_.push_back(block);
+  batch_offsets_.push_back(batch_offsets_.back() + batch.num_rows());
+  file_size_ += block.metadata_length + block.body_length;
+}
+
+std::shared_ptr<RecordBatch> RecordBatchSpool::ReadBatch(size_t index) {
+  const Block &block = blocks_.at(index);
+  if (block.offset + block.metadata_length + block.body_length > mapped_size_) {
+    // Batches read from the previous map keep it alive.
+    arrow::Result<std::shared_ptr<MemoryMappedFile>> mapped_file =
+        MemoryMappedFile::Open(path_, arrow::io::FileMode::READ);
+    ThrowIfNotOK(mapped_file.status());
+    mapped_file_ = std::move(mapped_file).ValueOrDie();
+    mapped_size_ = file_size_;
+  }
+
+  arrow::Result<std::unique_ptr<arrow::ipc::Message>> message =
+      arrow::ipc::ReadMessage(block.offset, block.metadata_length, mapped_file_.get());
+  ThrowIfNotOK(message.status());
+  if (!message.ValueOrDie()) {
+    throw DriverException("Unexpected end of the result cache file");
+  }
+
+  arrow::Result<std::shared_ptr<RecordBatch>> batch = arrow::ipc::ReadRecordBatch(
+      *message.ValueOrDie(), schema_, &dictionary_memo_, arrow::ipc::IpcReadOptions::Defaults());
+  ThrowIfNotOK(batch.status());
+  return std::move(batch).ValueOrDie();
+}
+
+size_t RecordBatchSpool::FindBatch(int64_t row) const {
+  // The last batch starting at or before the row. Empty batches share their
+  // offset with the next one and are skipped.
+  auto it = std::upper_bound(batch_offsets_.begin(), batch_offsets_.end() - 1, row);
+  return static_cast<size_t>(it - batch_offsets_.begin()) - 1;
+}
+
+} // namespace flight_sql
+} // namespace driver
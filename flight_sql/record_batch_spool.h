@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#pragma once
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/dictionary.h>
+#include <arrow/ipc/options.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <arrow/util/io_util.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace driver {
+namespace flight_sql {
+
+/// \brief Keeps record batches in a temporary Arrow IPC file, so results can
+/// be held without keeping them in memory.
+///
+/// Batches are read back from a memory map of the file, so their buffers are
+/// not copied unless they were compressed. Only the position of each batch is
+/// kept in memory. Dictionary-encoded columns are not supported.
+class RecordBatchSpool {
+public:
+  /// \brief Creates a spool backed by a file in a new temporary directory,
+  /// which is removed along with the spool.
+  /// \param schema The schema of every batch appended.
+  /// \param options The options batches are written with, e.g. their
+  ///                compression.
+  static std::unique_ptr<RecordBatchSpool>
+  Make(std::shared_ptr<arrow::Schema> schema,
+       const arrow::ipc::IpcWriteOptions &options = arrow::ipc::IpcWriteOptions::Defaults());
+
+  /// \brief Writes a batch at the end of the file.
+  void Append(const arrow::RecordBatch &batch);
+
+  /// \brief Reads the batch at the given index.
+  std::shared_ptr<arrow::RecordBatch> ReadBatch(size_t index);
+
+  /// \brief Returns the index of the batch holding the given row, which must
+  /// be less than num_rows().
+  size_t FindBatch(int64_t row) const;
+
+  /// \brief Returns the row the batch at the given index starts at.
+  int64_t GetBatchOffset(size_t index) const { return batch_offsets_[index]; }
+
+  size_t num_batches() const { return blocks_.size(); }
+
+  int64_t num_rows() const { return batch_offsets_.back(); }
+
+  /// \brief Returns the size of the file, in bytes.
+  int64_t size() const { return file_size_; }
+
+private:
+  /// \brief The location of a batch message in the file.
+  struct Block {
+    int64_t offset;
+    int32_t metadata_length;
+    int64_t body_length;
+  };
+
+  RecordBatchSpool(std::unique_ptr<arrow::internal::TemporaryDir> temp_dir,
+                   std::string path,
+                   std::shared_ptr<arrow::io::FileOutputStream> file,
+                   std::shared_ptr<arrow::Schema> schema,
+                   const arrow::ipc::IpcWriteOptions &options);
+
+  // Declared first so the file is closed before its directory is removed.
+  std::unique_ptr<arrow::internal::TemporaryDir> temp_dir_;
+  std::string path_;
+  std::shared_ptr<arrow::io::FileOutputStream> file_;
+  // Remapped when batches were written past its end.
+  std::shared_ptr<arrow::io::MemoryMappedFile> mapped_file_;
+  int64_t mapped_size_;
+  std::shared_ptr<arrow::Schema> schema_;
+  arrow::ipc::IpcWriteOptions options_;
+  arrow::ipc::DictionaryMemo dictionary_memo_;
+  std::vector<Block> blocks_;
+  // The first row of each batch, followed by the total number of rows.
+  std::vector<int64_t> batch_offsets_;
+  int64_t file_size_;
+};
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include <odbcabstraction/platform.h>
+#include "arrow/testing/builder.h"
+#include "record_batch_spool.h"
+#include "gtest/gtest.h"
+#include <arrow/record_batch.h>
+
+namespace driver {
+namespace flight_sql {
+
+using namespace arrow;
+
+namespace {
+std::shared_ptr<RecordBatch> MakeBatch(const std::vector<int32_t> &values) {
+  std::shared_ptr<Array> array;
+  ArrayFromVector<Int32Type, int32_t>(values, &array);
+  return RecordBatch::Make(arrow::schema({field("id", int32())}),
+                           static_cast<int64_t>(values.size()), {array});
+}
+} // namespace
+
+TEST(RecordBatchSpool, ReadsBatchesBack) {
+  auto first = MakeBatch({1, 2, 3});
+  auto second = MakeBatch({4, 5});
+  auto spool = RecordBatchSpool::Make(first->schema());
+
+  spool->Append(*first);
+  spool->Append(*second);
+
+  ASSERT_EQ(2, spool->num_batches());
+  ASSERT_EQ(5, spool->num_rows());
+  ASSERT_TRUE(spool->ReadBatch(1)->Equals(*second));
+  ASSERT_TRUE(spool->ReadBatch(0)->Equals(*first));
+}
+
+TEST(RecordBatchSpool, ReadsBatchesAppendedAfterReading) {
+  auto first = MakeBatch({1, 2, 3});
+  auto second = MakeBatch({4, 5});
+  auto spool = RecordBatchSpool::Make(first->schema());
+
+  spool->Append(*first);
+  auto read_first = spool->ReadBatch(0);
+  spool->Append(*second);
+
+  ASSERT_TRUE(spool->ReadBatch(1)->Equals(*second));
+  ASSERT_TRUE(read_first->Equals(*first));
+}
+
+TEST(RecordBatchSpool, FindsBatchOfRow) {
+  auto spool = RecordBatchSpool::Make(MakeBatch({})->schema());
+  spool->Append(*MakeBatch({1, 2, 3}));
+  spool->Append(*MakeBatch({}));
+  spool->Append(*MakeBatch({4, 5}));
+
+  ASSERT_EQ(0, spool->FindBatch(0));
+  ASSERT_EQ(0, spool->FindBatch(2));
+  ASSERT_EQ(2, spool->FindBatch(3));
+  ASSERT_EQ(2, spool->FindBatch(4));
+  ASSERT_EQ(3, spool->GetBatchOffset(2));
+}
+
+} // namespace flight_sql
+} // namespace driver
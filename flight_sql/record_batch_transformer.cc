@@ -10,6 +10,8 @@
 #include "utils.h"
 #include <arrow/array/util.h>
 #include <arrow/builder.h>
+#include <arrow/util/checked_cast.h>
+#include <arrow/util/key_value_metadata.h>
 #include <iostream>
 #include <utility>
 
@@ -19,6 +21,7 @@ namespace driver {
 namespace flight_sql {
 
 using namespace arrow;
+using arrow::internal::checked_cast;
 
 namespace {
 Result<std::shared_ptr<Array>> MakeEmptyArray(std::shared_ptr<DataType> type,
@@ -73,8 +76,96 @@ public:
     return schema(fields_);
   }
 };
+
+void FlattenField(const std::shared_ptr<Field> &original_field,
+                  const std::string &prefix, bool parent_nullable,
+                  std::vector<std::shared_ptr<Field>> &flattened_fields) {
+  const std::string name = prefix + original_field->name();
+  const bool nullable = parent_nullable || original_field->nullable();
+
+  if (original_field->type()->id() == Type::STRUCT) {
+    for (const auto &child : original_field->type()->fields()) {
+      FlattenField(child, name + ".", nullable, flattened_fields);
+    }
+    return;
+  }
+
+  // Column metadata readers expect every field to carry a metadata map.
+  std::shared_ptr<const KeyValueMetadata> metadata = original_field->metadata();
+  if (!metadata) {
+    metadata = std::make_shared<KeyValueMetadata>();
+  }
+  flattened_fields.push_back(field(name, original_field->type(), nullable, metadata));
+}
+
+void FlattenColumn(const std::shared_ptr<Array> &array,
+                   std::vector<std::shared_ptr<Array>> &flattened_arrays) {
+  if (array->type_id() != Type::STRUCT) {
+    flattened_arrays.push_back(array);
+    return;
+  }
+
+  // Flatten() only allocates when the parent has nulls to merge into the children.
+  const auto &children = checked_cast<const StructArray &>(*array).Flatten();
+  ThrowIfNotOK(children.status());
+  for (const auto &child : children.ValueOrDie()) {
+    FlattenColumn(child, flattened_arrays);
+  }
+}
+
+/// A transformer that replaces struct columns by their children.
+class StructFlatteningTransformer : public RecordBatchTransformer {
+private:
+  std::shared_ptr<Schema> schema_;
+
+public:
+  explicit StructFlatteningTransformer(std::shared_ptr<Schema> schema)
+      : schema_(std::move(schema)) {}
+
+  std::shared_ptr<RecordBatch>
+  Transform(const std::shared_ptr<RecordBatch> &original) override {
+    std::vector<std::shared_ptr<Array>> arrays;
+    arrays.reserve(schema_->num_fields());
+
+    for (const auto &column : original->columns()) {
+      FlattenColumn(column, arrays);
+    }
+
+    return RecordBatch::Make(schema_, original->num_rows(), arrays);
+  }
+
+  std::shared_ptr<Schema> GetTransformedSchema() override {
+    return schema_;
+  }
+};
 } // namespace
 
+std::shared_ptr<Schema> FlattenStructFields(const std::shared_ptr<Schema> &schema) {
+  std::vector<std::shared_ptr<Field>> fields;
+  fields.reserve(schema->num_fields());
+
+  for (const auto &original_field : schema->fields()) {
+    if (original_field->type()->id() == Type::STRUCT) {
+      FlattenField(original_field, "", false, fields);
+    } else {
+      fields.push_back(original_field);
+    }
+  }
+
+  return arrow::schema(fields, schema->metadata());
+}
+
+std::shared_ptr<RecordBatchTransformer>
+CreateStructFlatteningTransformer(const std::shared_ptr<Schema> &schema) {
+  for (const auto &original_field : schema->fields()) {
+    if (original_field->type()->id() == Type::STRUCT) {
+      return std::make_shared<StructFlatteningTransformer>(FlattenStructFields(schema));
+    }
+  }
+
+  return nullptr;
+}
+
 RecordBatchTransformerWithTasksBuilder &
 RecordBatchTransformerWithTasksBuilder::RenameField(
     const std::string &original_name, const std::string &transformed_name) {
@@ -39,6 +39,19 @@ public:
   virtual std::shared_ptr<Schema> GetTransformedSchema() = 0;
 };
 
+/// Returns a copy of the schema where each struct field is replaced by its
+/// children, named "parent.child". Nested structs are flattened recursively.
+/// \param schema   The original schema.
+/// \return the flattened schema.
+std::shared_ptr<Schema> FlattenStructFields(const std::shared_ptr<Schema> &schema);
+
+/// Creates a transformer that exposes each child of a struct column as a column
+/// of its own, reusing the child arrays instead of copying them.
+/// \param schema   The schema from the original RecordBatch.
+/// \return the transformer, or nullptr if the schema has no struct fields.
+std::shared_ptr<RecordBatchTransformer>
+CreateStructFlatteningTransformer(const std::shared_ptr<Schema> &schema);
+
 class RecordBatchTransformerWithTasksBuilder {
 private:
   std::vector<std::shared_ptr<Field>> new_fields_;
@@ -145,5 +145,44 @@ TEST(Transformer, TransformerChangingOrderOfArrayTest) {
   ASSERT_EQ(transformed_record_batch->GetColumnByName("test2"), second_array);
   ASSERT_EQ(transformed_record_batch->GetColumnByName("test1"), first_array);
 }
+
+TEST(Transformer, StructFlatteningTest) {
+  std::shared_ptr<Array> id_array;
+  std::shared_ptr<Array> x_array;
+  std::shared_ptr<Array> name_array;
+  ArrayFromVector<Int32Type, int32_t>({1, 2, 3}, &id_array);
+  ArrayFromVector<DoubleType, double>({1.5, 2.5, 3.5}, &x_array);
+  ArrayFromVector<StringType, std::string>({"a", "b", "c"}, &name_array);
+
+  auto inner_array = StructArray::Make({x_array}, {"x"}).ValueOrDie();
+  auto struct_array = StructArray::Make({name_array, inner_array}, {"name", "inner"}).ValueOrDie();
+
+  auto schema = arrow::schema({field("id", int32(), false),
+                               field("col", struct_array->type())});
+  auto original_record_batch = RecordBatch::Make(schema, 3, {id_array, struct_array});
+
+  auto transformer = CreateStructFlatteningTransformer(schema);
+  ASSERT_NE(nullptr, transformer);
+
+  auto transformed_schema = transformer->GetTransformedSchema();
+  ASSERT_EQ(3, transformed_schema->num_fields());
+  ASSERT_EQ(0, transformed_schema->GetFieldIndex("id"));
+  ASSERT_EQ(1, transformed_schema->GetFieldIndex("col.name"));
+  ASSERT_EQ(2, transformed_schema->GetFieldIndex("col.inner.x"));
+  ASSERT_TRUE(transformed_schema->field(2)->type()->Equals(float64()));
+
+  auto transformed_record_batch = transformer->Transform(original_record_batch);
+
+  // Children of a struct without nulls are reused as they are.
+  ASSERT_EQ(id_array, transformed_record_batch->column(0));
+  ASSERT_TRUE(name_array->Equals(transformed_record_batch->column(1)));
+  ASSERT_TRUE(x_array->Equals(transformed_record_batch->column(2)));
+}
+
+TEST(Transformer, StructFlatteningWithoutStructsTest) {
+  auto original_record_batch = CreateOriginalRecordBatch();
+
+  ASSERT_EQ(nullptr, CreateStructFlatteningTransformer(original_record_batch->schema()));
+}
 } // namespace flight_sql
 } // namespace driver
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "result_set_batch_reader.h"
+
+#include <algorithm>
+
+namespace driver {
+namespace flight_sql {
+
+using arrow::RecordBatch;
+using arrow::Status;
+
+ResultSetBatchReader::ResultSetBatchReader(std::shared_ptr<arrow::Schema> schema,
+                                           Supplier supplier,
+                                           std::shared_ptr<RecordBatch> first_batch,
+                                           std::shared_ptr<std::atomic<bool>> closed,
+                                           boost::optional<int64_t> max_rows)
+    : schema_(std::move(schema)), supplier_(std::move(supplier)),
+      first_batch_(std::move(first_batch)), closed_(std::move(closed)),
+      remaining_rows_(max_rows) {}
+
+Status ResultSetBatchReader::ReadNext(std::shared_ptr<RecordBatch> *batch) {
+  if (remaining_rows_ && *remaining_rows_ <= 0) {
+    batch->reset();
+    return Status::OK();
+  }
+
+  if (first_batch_) {
+    *batch = std::move(first_batch_);
+  } else {
+    try {
+      if (!supplier_(batch)) {
+        batch->reset();
+        // A closed result set stops the stream without reaching its end.
+        if (*closed_) {
+          return Status::Cancelled("The result set was closed before the stream was read to its end");
+        }
+        return Status::OK();
+      }
+    } catch (const std::exception &e) {
+      return Status::IOError(e.what());
+    }
+  }
+
+  if (remaining_rows_) {
+    if ((*batch)->num_rows() > *remaining_rows_) {
+      *batch = (*batch)->Slice(0, *remaining_rows_);
+    }
+    *remaining_rows_ -= (*batch)->num_rows();
+  }
+  return Status::OK();
+}
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#pragma once
+
+#include <arrow/record_batch.h>
+#include <arrow/status.h>
+#include <arrow/type.h>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace driver {
+namespace flight_sql {
+
+/// \brief Reads the batches left in a result set, for exporting them as an
+/// Arrow C stream.
+class ResultSetBatchReader : public arrow::RecordBatchReader {
+public:
+  /// \brief Gets the next batch of the result set. Returns false at its end,
+  /// or when it was closed. May throw.
+  typedef std::function<bool(std::shared_ptr<arrow::RecordBatch> *)> Supplier;
+
+  /// \param schema The schema of the batches.
+  /// \param supplier Gets the batches after first_batch.
+  /// \param first_batch Read before the supplier's batches. May be null.
+  /// \param closed Set by the result set when it is closed before its end, so
+  ///               the stream fails rather than ending with missing rows.
+  /// \param max_rows The number of rows the stream ends after, if any.
+  ResultSetBatchReader(std::shared_ptr<arrow::Schema> schema, Supplier supplier,
+                       std::shared_ptr<arrow::RecordBatch> first_batch,
+                       std::shared_ptr<std::atomic<bool>> closed,
+                       boost::optional<int64_t> max_rows);
+
+  std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch> *batch) override;
+
+private:
+  std::shared_ptr<arrow::Schema> schema_;
+  Supplier supplier_;
+  std::shared_ptr<arrow::RecordBatch> first_batch_;
+  std::shared_ptr<std::atomic<bool>> closed_;
+  boost::optional<int64_t> remaining_rows_;
+};
+
+} // namespace flight_sql
+} // namespace driver
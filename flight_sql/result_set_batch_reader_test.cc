@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "arrow/testing/builder.h"
+#include "result_set_batch_reader.h"
+#include "gtest/gtest.h"
+#include <arrow/c/abi.h>
+#include <arrow/c/bridge.h>
+#include <arrow/record_batch.h>
+
+#include <deque>
+
+namespace driver {
+namespace flight_sql {
+
+using namespace arrow;
+
+namespace {
+std::shared_ptr<RecordBatch> MakeBatch(const std::vector<int32_t> &values) {
+  std::shared_ptr<Array> array;
+  ArrayFromVector<Int32Type, int32_t>(values, &array);
+  return RecordBatch::Make(arrow::schema({field("id", int32())}),
+                           static_cast<int64_t>(values.size()), {array});
+}
+
+// Supplies the given batches, then reports the end of the result.
+ResultSetBatchReader::Supplier SupplyBatches(std::deque<std::shared_ptr<RecordBatch>> batches) {
+  auto remaining = std::make_shared<std::deque<std::shared_ptr<RecordBatch>>>(std::move(batches));
+  return [remaining](std::shared_ptr<RecordBatch> *batch) -> bool {
+    if (remaining->empty()) {
+      return false;
+    }
+    *batch = remaining->front();
+    remaining->pop_front();
+    return true;
+  };
+}
+} // namespace
+
+TEST(ResultSetBatchReader, ReadsFirstBatchThenSuppliedOnes) {
+  auto first = MakeBatch({1, 2});
+  auto second = MakeBatch({3, 4, 5});
+  auto closed = std::make_shared<std::atomic<bool>>(false);
+  ResultSetBatchReader reader(first->schema(), SupplyBatches({second}), first, closed, boost::none);
+
+  std::shared_ptr<RecordBatch> batch;
+  ASSERT_TRUE(reader.ReadNext(&batch).ok());
+  ASSERT_TRUE(batch->Equals(*first));
+  ASSERT_TRUE(reader.ReadNext(&batch).ok());
+  ASSERT_TRUE(batch->Equals(*second));
+  ASSERT_TRUE(reader.ReadNext(&batch).ok());
+  ASSERT_EQ(nullptr, batch);
+}
+
+TEST(ResultSetBatchReader, FailsWhenClosedBeforeTheEnd) {
+  auto first = MakeBatch({1, 2});
+  auto closed = std::make_shared<std::atomic<bool>>(false);
+  // A closed result set supplies no more batches.
+  ResultSetBatchReader reader(first->schema(), SupplyBatches({}), first, closed, boost::none);
+
+  std::shared_ptr<RecordBatch> batch;
+  ASSERT_TRUE(reader.ReadNext(&batch).ok());
+  *closed = true;
+  ASSERT_TRUE(reader.ReadNext(&batch).IsCancelled());
+  ASSERT_EQ(nullptr, batch);
+}
+
+TEST(ResultSetBatchReader, EndsAfterMaxRows) {
+  auto first = MakeBatch({1, 2});
+  auto second = MakeBatch({3, 4, 5});
+  auto third = MakeBatch({6});
+  auto closed = std::make_shared<std::atomic<bool>>(false);
+  ResultSetBatchReader reader(first->schema(), SupplyBatches({second, third}), first, closed,
+                              int64_t{3});
+
+  std::shared_ptr<RecordBatch> batch;
+  ASSERT_TRUE(reader.ReadNext(&batch).ok());
+  ASSERT_TRUE(batch->Equals(*first));
+  ASSERT_TRUE(reader.ReadNext(&batch).ok());
+  ASSERT_TRUE(batch->Equals(*MakeBatch({3})));
+  // The limit ends the stream even once the result set is closed.
+  *closed = true;
+  ASSERT_TRUE(reader.ReadNext(&batch).ok());
+  ASSERT_EQ(nullptr, batch);
+}
+
+TEST(ResultSetBatchReader, ExportsAsArrowStream) {
+  auto first = MakeBatch({1, 2});
+  auto second = MakeBatch({3, 4, 5});
+  auto closed = std::make_shared<std::atomic<bool>>(false);
+  auto reader = std::make_shared<ResultSetBatchReader>(first->schema(), SupplyBatches({second}),
+                                                       first, closed, int64_t{4});
+
+  struct ArrowArrayStream stream;
+  ASSERT_TRUE(ExportRecordBatchReader(reader, &stream).ok());
+  auto imported = ImportRecordBatchReader(&stream);
+  ASSERT_TRUE(imported.ok());
+
+  std::shared_ptr<RecordBatch> batch;
+  int64_t rows = 0;
+  do {
+    ASSERT_TRUE((*imported)->ReadNext(&batch).ok());
+    rows += batch ? batch->num_rows() : 0;
+  } while (batch);
+  ASSERT_EQ(4, rows);
+}
+
+} // namespace flight_sql
+} // namespace driver
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include "spilling_queue.h"
+
+#include <arrow/ipc/options.h>
+#include <arrow/util/byte_size.h>
+#include <arrow/util/compression.h>
+
+namespace driver {
+namespace flight_sql {
+
+using arrow::RecordBatch;
+using arrow::Result;
+using arrow::Status;
+
+namespace {
+
+/// \brief Compresses spilled batches with ZSTD, or LZ4 when Arrow was built
+/// without it. Batches are written uncompressed if neither is available.
+arrow::ipc::IpcWriteOptions GetSpillWriteOptions() {
+  arrow::ipc::IpcWriteOptions options = arrow::ipc::IpcWriteOptions::Defaults();
+  for (auto compression : {arrow::Compression::ZSTD, arrow::Compression::LZ4_FRAME}) {
+    if (!arrow::util::Codec::IsAvailable(compression)) {
+      continue;
+    }
+
+    Result<std::unique_ptr<arrow::util::Codec>> codec = arrow::util::Codec::Create(compression);
+    if (codec.ok()) {
+      options.codec = std::move(codec).ValueOrDie();
+      break;
+    }
+  }
+  return options;
+}
+
+} // namespace
+
+SpillingQueue::SpillingQueue(int64_t memory_limit)
+    : memory_limit_(memory_limit), memory_used_(0), next_spooled_batch_(0),
+      spilled_batches_(0), active_producers_(0), closed_(false) {}
+
+SpillingQueue::~SpillingQueue() {
+  Close();
+}
+
+void SpillingQueue::AddProducer(Supplier supplier) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  active_producers_++;
+  threads_.emplace_back([this, supplier] {
+    while (true) {
+      // Reading from the server happens without the lock, so producers work
+      // in parallel and the consumer pops batches meanwhile.
+      Result<std::shared_ptr<RecordBatch>> result = supplier();
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) {
+        break;
+      }
+      if (!result.ok()) {
+        if (status_.ok()) {
+          status_ = result.status();
+        }
+        not_empty_.notify_all();
+        break;
+      }
+      if (!result.ValueOrDie()) {
+        break;
+      }
+
+      try {
+        Push(std::move(result).ValueOrDie());
+      } catch (const std::exception &e) {
+        status_ = Status::IOError(e.what());
+        not_empty_.notify_all();
+        break;
+      }
+      not_empty_.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_producers_--;
+    not_empty_.notify_all();
+  });
+}
+
+void SpillingQueue::Push(std::shared_ptr<RecordBatch> batch) {
+  const int64_t size = arrow::util::TotalBufferSize(*batch);
+
+  // Batches go to disk as long as older ones are there, so they are read in
+  // the order they arrived. The file is written under the lock for the same
+  // reason.
+  if (!HasSpooledBatches() && (batches_.empty() || memory_used_ + size <= memory_limit_)) {
+    memory_used_ += size;
+    batches_.emplace_back(std::move(batch), size);
+    return;
+  }
+
+  if (!spool_) {
+    spool_ = RecordBatchSpool::Make(batch->schema(), GetSpillWriteOptions());
+  }
+  spool_->Append(*batch);
+  spilled_batches_++;
+}
+
+bool SpillingQueue::Pop(Result<std::shared_ptr<RecordBatch>> *result) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this] {
+    return closed_ || !status_.ok() || !batches_.empty() || HasSpooledBatches() ||
+           active_producers_ == 0;
+  });
+
+  if (closed_) {
+    return false;
+  }
+
+  if (!status_.ok()) {
+    *result = status_;
+    return true;
+  }
+
+  if (!batches_.empty()) {
+    memory_used_ -= batches_.front().second;
+    *result = std::move(batches_.front().first);
+    batches_.pop_front();
+    return true;
+  }
+
+  if (HasSpooledBatches()) {
+    *result = spool_->ReadBatch(next_spooled_batch_++);
+    if (next_spooled_batch_ == spool_->num_batches()) {
+      // The consumer caught up, so the file is no longer needed.
+      spool_.reset();
+      next_spooled_batch_ = 0;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+void SpillingQueue::Close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  batches_.clear();
+  memory_used_ = 0;
+  spool_.reset();
+}
+
+size_t SpillingQueue::spilled_batches() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return spilled_batches_;
+}
+
+bool SpillingQueue::HasSpooledBatches() const {
+  return spool_ && next_spooled_batch_ < spool_->num_batches();
+}
+
+} // namespace flight_sql
+} // namespace driver
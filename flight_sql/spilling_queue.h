@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#pragma once
+
+#include "record_batch_spool.h"
+
+#include <arrow/record_batch.h>
+#include <arrow/result.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace driver {
+namespace flight_sql {
+
+/// \brief An unbounded queue of record batches read by producer threads.
+///
+/// Producers never wait for the consumer: once the batches held in memory
+/// reach the memory limit, the following ones are written to a temporary
+/// compressed IPC file and read back when the consumer gets to them. This lets
+/// streams be drained at network speed with bounded memory.
+class SpillingQueue {
+public:
+  /// \brief Returns the next batch of a stream, or null at its end.
+  typedef std::function<arrow::Result<std::shared_ptr<arrow::RecordBatch>>()> Supplier;
+
+  /// \param memory_limit The size of the batches kept in memory, in bytes.
+  explicit SpillingQueue(int64_t memory_limit);
+
+  ~SpillingQueue();
+
+  /// \brief Starts a thread adding the batches of the supplier to the queue.
+  void AddProducer(Supplier supplier);
+
+  /// \brief Takes the next batch, waiting for one to be produced. An error of
+  /// a producer is returned in place of the remaining batches.
+  /// \returns false once every producer ended and every batch was taken, or
+  ///          when the queue was closed.
+  bool Pop(arrow::Result<std::shared_ptr<arrow::RecordBatch>> *result);
+
+  /// \brief Drops the batches left and joins the producers. Producers blocked
+  /// in their supplier must be unblocked first.
+  void Close();
+
+  /// \brief Returns the number of batches written to disk so far.
+  size_t spilled_batches();
+
+private:
+  /// \brief Returns true if batches written to disk were not taken yet.
+  bool HasSpooledBatches() const;
+
+  void Push(std::shared_ptr<arrow::RecordBatch> batch);
+
+  const int64_t memory_limit_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  // Batches held in memory, with their size. They are older than any batch in
+  // the spool.
+  std::deque<std::pair<std::shared_ptr<arrow::RecordBatch>, int64_t>> batches_;
+  int64_t memory_used_;
+  // Removed once the consumer has read every batch written to it.
+  std::unique_ptr<RecordBatchSpool> spool_;
+  size_t next_spooled_batch_;
+  size_t spilled_batches_;
+  arrow::Status status_;
+  size_t active_producers_;
+  bool closed_;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace flight_sql
+} // namespace driver
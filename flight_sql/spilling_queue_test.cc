@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include <odbcabstraction/platform.h>
+#include "arrow/testing/builder.h"
+#include "spilling_queue.h"
+#include "gtest/gtest.h"
+#include <arrow/record_batch.h>
+
+#include <future>
+
+namespace driver {
+namespace flight_sql {
+
+using namespace arrow;
+
+namespace {
+std::shared_ptr<RecordBatch> MakeBatch(int32_t first_value) {
+  std::vector<int32_t> values = {first_value, first_value + 1, first_value + 2};
+  std::shared_ptr<Array> array;
+  ArrayFromVector<Int32Type, int32_t>(values, &array);
+  return RecordBatch::Make(arrow::schema({field("id", int32())}),
+                           static_cast<int64_t>(values.size()), {array});
+}
+
+/// \brief Supplies the given batches, then the end of the stream.
+/// \param ended If set, fulfilled once every batch was queued.
+SpillingQueue::Supplier MakeSupplier(std::vector<std::shared_ptr<RecordBatch>> batches,
+                                     std::shared_ptr<std::promise<void>> ended = nullptr) {
+  auto remaining = std::make_shared<std::vector<std::shared_ptr<RecordBatch>>>(std::move(batches));
+  auto next = std::make_shared<size_t>(0);
+  return [remaining, next, ended]() -> Result<std::shared_ptr<RecordBatch>> {
+    if (*next == remaining->size()) {
+      // The producer queues each batch before asking for the next one.
+      if (ended) {
+        ended->set_value();
+      }
+      return std::shared_ptr<RecordBatch>();
+    }
+    return (*remaining)[(*next)++];
+  };
+}
+} // namespace
+
+TEST(SpillingQueue, KeepsOrderWhenSpilling) {
+  std::vector<std::shared_ptr<RecordBatch>> batches;
+  for (int32_t i = 0; i < 5; ++i) {
+    batches.push_back(MakeBatch(i * 3));
+  }
+
+  // Only one batch fits in memory. Popping starts once all of them were
+  // queued, so the ones after the first were spilled.
+  SpillingQueue queue(1);
+  auto ended = std::make_shared<std::promise<void>>();
+  std::future<void> all_queued = ended->get_future();
+  queue.AddProducer(MakeSupplier(batches, ended));
+  all_queued.wait();
+  ASSERT_EQ(batches.size() - 1, queue.spilled_batches());
+
+  for (const auto &batch : batches) {
+    Result<std::shared_ptr<RecordBatch>> result;
+    ASSERT_TRUE(queue.Pop(&result));
+    ASSERT_TRUE(result.ok());
+    ASSERT_TRUE(result.ValueOrDie()->Equals(*batch));
+  }
+
+  Result<std::shared_ptr<RecordBatch>> result;
+  ASSERT_FALSE(queue.Pop(&result));
+}
+
+TEST(SpillingQueue, KeepsBatchesInMemoryBelowLimit) {
+  SpillingQueue queue(1024 * 1024);
+  queue.AddProducer(MakeSupplier({MakeBatch(0), MakeBatch(3)}));
+
+  Result<std::shared_ptr<RecordBatch>> result;
+  ASSERT_TRUE(queue.Pop(&result));
+  ASSERT_TRUE(queue.Pop(&result));
+  ASSERT_FALSE(queue.Pop(&result));
+  ASSERT_EQ(0, queue.spilled_batches());
+}
+
+TEST(SpillingQueue, ReturnsProducerError) {
+  SpillingQueue queue(1);
+  queue.AddProducer([]() -> Result<std::shared_ptr<RecordBatch>> {
+    return Status::IOError("stream failed");
+  });
+
+  Result<std::shared_ptr<RecordBatch>> result;
+  ASSERT_TRUE(queue.Pop(&result));
+  ASSERT_TRUE(result.status().IsIOError());
+}
+
+} // namespace flight_sql
+} // namespace driver
@@ -20,6 +20,8 @@
 
 #include <boost/tokenizer.hpp>
 
+#include <cctype>
+#include <set>
 #include <sstream>
 #include <ctime>
 
@@ -696,6 +698,205 @@ boost::xpressive::sregex ConvertSqlPatternToRegex(const std::string &pattern) {
   return boost::xpressive::sregex(boost::xpressive::sregex::compile(regex_str));
 }
 
+std::string GetLeadingKeyword(const std::string &query) {
+  size_t pos = 0;
+  while (pos < query.size()) {
+    if (std::isspace(static_cast<unsigned char>(query[pos])) || query[pos] == '(') {
+      ++pos;
+    } else if (query.compare(pos, 2, "--") == 0) {
+      pos = query.find('\n', pos);
+    } else if (query.compare(pos, 2, "/*") == 0) {
+      pos = query.find("*/", pos + 2);
+      pos = pos == std::string::npos ? pos : pos + 2;
+    } else {
+      break;
+    }
+  }
+
+  std::string keyword;
+  while (pos < query.size() &&
+         (std::isalnum(static_cast<unsigned char>(query[pos])) || query[pos] == '_')) {
+    keyword += static_cast<char>(std::toupper(static_cast<unsigned char>(query[pos])));
+    ++pos;
+  }
+  return keyword;
+}
+
+namespace {
+
+bool IsIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/// \brief Returns the upper-cased word at pos, or an empty string if pos is
+/// not on a word.
+std::string ReadWord(const std::string &query, size_t pos) {
+  std::string word;
+  while (pos < query.size() && IsIdentifierChar(query[pos])) {
+    word += static_cast<char>(std::toupper(static_cast<unsigned char>(query[pos])));
+    ++pos;
+  }
+  return word;
+}
+
+/// \brief Returns the word following the one ending at pos.
+std::string ReadNextWord(const std::string &query, size_t pos) {
+  while (pos < query.size() && std::isspace(static_cast<unsigned char>(query[pos]))) {
+    ++pos;
+  }
+  return ReadWord(query, pos);
+}
+
+/// \brief Returns the position after the quote closing the one at pos, or
+/// npos if it is not closed. Backslashes escape the character after them.
+size_t SkipQuoted(const std::string &query, size_t pos) {
+  const char quote = query[pos];
+  for (++pos; pos < query.size(); ++pos) {
+    if (query[pos] == '\\') {
+      ++pos;
+    } else if (query[pos] == quote) {
+      return pos + 1;
+    }
+  }
+  return std::string::npos;
+}
+
+/// \brief Returns the position after the dollar-quote tag at pos, as in
+/// $$ or $body$, or npos if there is none. $1 is a parameter, not a tag.
+size_t FindDollarTagEnd(const std::string &query, size_t pos) {
+  if (pos > 0 && IsIdentifierChar(query[pos - 1])) {
+    return std::string::npos;
+  }
+
+  size_t end = pos + 1;
+  if (end < query.size() && std::isdigit(static_cast<unsigned char>(query[end]))) {
+    return std::string::npos;
+  }
+  while (end < query.size() && IsIdentifierChar(query[end])) {
+    ++end;
+  }
+  return end < query.size() && query[end] == '$' ? end + 1 : std::string::npos;
+}
+
+/// \brief Returns true if the statement has a RETURNING clause, or an OUTPUT
+/// one as in T-SQL, outside quotes, comments and parentheses.
+bool HasReturningClause(const std::string &query) {
+  size_t pos = 0;
+  int paren_depth = 0;
+  while (pos < query.size()) {
+    const char c = query[pos];
+    size_t tag_end;
+    if (c == '\'' || c == '"' || c == '`') {
+      pos = SkipQuoted(query, pos);
+    } else if (c == '$' && (tag_end = FindDollarTagEnd(query, pos)) != std::string::npos) {
+      const std::string tag = query.substr(pos, tag_end - pos);
+      pos = query.find(tag, tag_end);
+      pos = pos == std::string::npos ? pos : pos + tag.size();
+    } else if (query.compare(pos, 2, "--") == 0) {
+      pos = query.find('\n', pos);
+    } else if (query.compare(pos, 2, "/*") == 0) {
+      pos = query.find("*/", pos + 2);
+      pos = pos == std::string::npos ? pos : pos + 2;
+    } else if (IsIdentifierChar(c) && (pos == 0 || (!IsIdentifierChar(query[pos - 1]) && query[pos - 1] != '.'))) {
+      const std::string word = ReadWord(query, pos);
+      pos += word.size();
+      if (paren_depth > 0) {
+        continue;
+      }
+      if (word == "RETURNING") {
+        return true;
+      }
+      // OUTPUT is also a common column name, so the clause is only recognized
+      // by the rows it returns.
+      if (word == "OUTPUT") {
+        size_t next = query.find_first_not_of(" \t\r\n", pos);
+        const std::string next_word = ReadWord(query, next == std::string::npos ? query.size() : next);
+        if (next_word == "INSERTED" || next_word == "DELETED" ||
+            (next != std::string::npos && query.compare(next, 7, "$action") == 0)) {
+          return true;
+        }
+      }
+    } else {
+      if (c == '(') {
+        ++paren_depth;
+      } else if (c == ')' && paren_depth > 0) {
+        --paren_depth;
+      }
+      ++pos;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+bool IsUpdateStatement(const std::string &query) {
+  static const std::set<std::string> update_keywords = {
+      "INSERT", "UPDATE", "DELETE", "MERGE", "UPSERT", "TRUNCATE"};
+  // Updates returning rows are executed as queries, so the rows are kept.
+  return update_keywords.count(GetLeadingKeyword(query)) > 0 && !HasReturningClause(query);
+}
+
+std::vector<std::string> SplitStatements(const std::string &query) {
+  // BEGIN as a statement of its own starts a transaction, not a block.
+  static const std::set<std::string> transaction_words = {
+      "", "TRANSACTION", "TRAN", "WORK", "ISOLATION", "DEFERRED", "IMMEDIATE", "EXCLUSIVE"};
+  // END followed by these closes a statement inside a block, not the block.
+  static const std::set<std::string> compound_statements = {
+      "IF", "LOOP", "WHILE", "REPEAT", "FOR"};
+
+  std::vector<std::string> statements;
+  size_t start = 0;
+  size_t pos = 0;
+  int block_depth = 0;
+  auto add_statement = [&](size_t end) {
+    std::string statement = query.substr(start, end - start);
+    if (!GetLeadingKeyword(statement).empty()) {
+      statements.push_back(std::move(statement));
+    }
+  };
+
+  // Anything left open makes the rest of the text a single statement, as
+  // sending it unchanged is safer than splitting it in the wrong place.
+  while (pos < query.size()) {
+    const char c = query[pos];
+    size_t tag_end;
+    if (c == '\'' || c == '"' || c == '`') {
+      // Quotes are escaped by doubling them, which reads as two quoted parts.
+      pos = SkipQuoted(query, pos);
+    } else if (c == '$' && (tag_end = FindDollarTagEnd(query, pos)) != std::string::npos) {
+      const std::string tag = query.substr(pos, tag_end - pos);
+      pos = query.find(tag, tag_end);
+      pos = pos == std::string::npos ? pos : pos + tag.size();
+    } else if (query.compare(pos, 2, "--") == 0) {
+      pos = query.find('\n', pos);
+    } else if (query.compare(pos, 2, "/*") == 0) {
+      pos = query.find("*/", pos + 2);
+      pos = pos == std::string::npos ? pos : pos + 2;
+    } else if (IsIdentifierChar(c) && (pos == 0 || (!IsIdentifierChar(query[pos - 1]) && query[pos - 1] != '.'))) {
+      // Semicolons inside BEGIN ... END and CASE ... END end the statements
+      // of a procedure body, not the batch.
+      const std::string word = ReadWord(query, pos);
+      pos += word.size();
+      if (word == "CASE") {
+        ++block_depth;
+      } else if (word == "BEGIN" && !transaction_words.count(ReadNextWord(query, pos))) {
+        ++block_depth;
+      } else if (word == "END" && block_depth > 0 && !compound_statements.count(ReadNextWord(query, pos))) {
+        --block_depth;
+      }
+    } else if (c == ';' && block_depth == 0) {
+      add_statement(pos);
+      start = ++pos;
+    } else {
+      ++pos;
+    }
+  }
+  add_statement(query.size());
+
+  return statements;
+}
+
 bool NeedArrayConversion(arrow::Type::type original_type_id, odbcabstraction::CDataType data_type) {
   switch (original_type_id) {
     case arrow::Type::DATE32:
@@ -708,7 +909,8 @@ bool NeedArrayConversion(arrow::Type::type original_type_id, odbcabstraction::CD
       return data_type != odbcabstraction::CDataType_TIMESTAMP;
     case arrow::Type::STRING:
       return data_type != odbcabstraction::CDataType_CHAR &&
-             data_type != odbcabstraction::CDataType_WCHAR;
+             data_type != odbcabstraction::CDataType_WCHAR &&
+             data_type != odbcabstraction::CDataType_STRING_VIEW;
     case arrow::Type::INT16:
       return data_type != odbcabstraction::CDataType_SSHORT;
     case arrow::Type::UINT16:
@@ -732,7 +934,11 @@ bool NeedArrayConversion(arrow::Type::type original_type_id, odbcabstraction::CD
     case arrow::Type::UINT64:
       return data_type != odbcabstraction::CDataType_UBIGINT;
     case arrow::Type::BINARY:
-      return data_type != odbcabstraction::CDataType_BINARY;
+      // Character targets are hex encoded by the accessor.
+      return data_type != odbcabstraction::CDataType_BINARY &&
+             data_type != odbcabstraction::CDataType_CHAR &&
+             data_type != odbcabstraction::CDataType_WCHAR &&
+             data_type != odbcabstraction::CDataType_STRING_VIEW;
     case arrow::Type::DECIMAL128:
       return data_type != odbcabstraction::CDataType_NUMERIC;
     case arrow::Type::LIST:
@@ -740,7 +946,8 @@ bool NeedArrayConversion(arrow::Type::type original_type_id, odbcabstraction::CD
     case arrow::Type::FIXED_SIZE_LIST:
     case arrow::Type::MAP:
     case arrow::Type::STRUCT:
-      return data_type == odbcabstraction::CDataType_CHAR || data_type == odbcabstraction::CDataType_WCHAR;
+      return data_type == odbcabstraction::CDataType_CHAR || data_type == odbcabstraction::CDataType_WCHAR ||
+             data_type == odbcabstraction::CDataType_STRING_VIEW;
     default:
       throw odbcabstraction::DriverException(std::string("Invalid conversion"));
   }
@@ -793,6 +1000,7 @@ ConvertCToArrowType(odbcabstraction::CDataType data_type) {
   switch (data_type) {
     case odbcabstraction::CDataType_CHAR:
     case odbcabstraction::CDataType_WCHAR:
+    case odbcabstraction::CDataType_STRING_VIEW:
       return arrow::Type::STRING;
     case odbcabstraction::CDataType_SSHORT:
       return arrow::Type::INT16;
@@ -968,7 +1176,8 @@ ArrayConvertTask GetConverter(arrow::Type::type original_type_id,
     };
   } else if (original_type_id == arrow::Type::DECIMAL128 &&
              (target_type == odbcabstraction::CDataType_CHAR ||
-              target_type == odbcabstraction::CDataType_WCHAR)) {
+              target_type == odbcabstraction::CDataType_WCHAR ||
+              target_type == odbcabstraction::CDataType_STRING_VIEW)) {
     return [=](const std::shared_ptr<arrow::Array> &original_array) {
       arrow::StringBuilder builder;
       int64_t length = original_array->length();
@@ -997,7 +1206,8 @@ ArrayConvertTask GetConverter(arrow::Type::type original_type_id,
     };
   } else if (IsComplexType(original_type_id) &&
              (target_type == odbcabstraction::CDataType_CHAR ||
-              target_type == odbcabstraction::CDataType_WCHAR)) {
+              target_type == odbcabstraction::CDataType_WCHAR ||
+              target_type == odbcabstraction::CDataType_STRING_VIEW)) {
     return [=](const std::shared_ptr<arrow::Array> &original_array) {
       const auto &json_conversion_result = ConvertToJson(original_array);
       ThrowIfNotOK(json_conversion_result.status());
@@ -86,6 +86,20 @@ optional<int32_t> GetDisplaySize(odbcabstraction::SqlDataType data_type,
 
 std::string ConvertSqlPatternToRegexString(const std::string &pattern);
 
+/// \brief Returns the first keyword of a statement in upper case, skipping
+/// whitespace, comments and opening parentheses before it.
+std::string GetLeadingKeyword(const std::string &query);
+
+/// \brief Returns true if the statement returns an update count rather than
+/// rows, judging by its leading keyword. Updates with a RETURNING or OUTPUT
+/// clause return rows.
+bool IsUpdateStatement(const std::string &query);
+
+/// \brief Splits a batch of statements on the semicolons between them,
+/// ignoring those inside quotes, dollar quotes, comments and BEGIN ... END
+/// blocks. Statements holding only whitespace and comments are dropped.
+std::vector<std::string> SplitStatements(const std::string &query);
+
 boost::xpressive::sregex ConvertSqlPatternToRegex(const std::string &pattern);
 
 bool NeedArrayConversion(arrow::Type::type original_type_id,
@@ -142,6 +142,75 @@ TEST(Utils, ConvertSqlPatternToRegexString) {
   ASSERT_EQ(std::string("X_Y"), ConvertSqlPatternToRegexString("X\\_Y"));
 }
 
+TEST(Utils, GetLeadingKeyword) {
+  ASSERT_EQ(std::string("SELECT"), GetLeadingKeyword("  select 1"));
+  ASSERT_EQ(std::string("INSERT"), GetLeadingKeyword("-- comment\n insert into t values (1)"));
+  ASSERT_EQ(std::string("UPDATE"), GetLeadingKeyword("/* comment */ (Update t set a = 1)"));
+  ASSERT_EQ(std::string(""), GetLeadingKeyword("/* unterminated"));
+}
+
+TEST(Utils, IsUpdateStatement) {
+  ASSERT_TRUE(IsUpdateStatement("INSERT INTO t VALUES (1)"));
+  ASSERT_TRUE(IsUpdateStatement("delete from t"));
+  ASSERT_FALSE(IsUpdateStatement("SELECT * FROM t"));
+  ASSERT_FALSE(IsUpdateStatement("WITH x AS (SELECT 1) SELECT * FROM x"));
+  ASSERT_FALSE(IsUpdateStatement("delete_rows()"));
+}
+
+TEST(Utils, IsUpdateStatementWithReturnedRows) {
+  ASSERT_FALSE(IsUpdateStatement("INSERT INTO t VALUES (1) RETURNING id"));
+  ASSERT_FALSE(IsUpdateStatement("update t set a = 1\nreturning *"));
+  ASSERT_FALSE(IsUpdateStatement("DELETE FROM t WHERE a > 1 RETURNING a, b"));
+  ASSERT_FALSE(IsUpdateStatement("INSERT INTO t (a) OUTPUT inserted.id VALUES (1)"));
+  ASSERT_FALSE(IsUpdateStatement("DELETE FROM t OUTPUT DELETED.* WHERE a = 1"));
+  ASSERT_FALSE(IsUpdateStatement(
+      "MERGE INTO t USING s ON t.id = s.id WHEN MATCHED THEN DELETE OUTPUT $action, deleted.id;"));
+
+  // Quotes, comments and nested parentheses hold no clause.
+  ASSERT_TRUE(IsUpdateStatement("INSERT INTO t VALUES ('returning')"));
+  ASSERT_TRUE(IsUpdateStatement("INSERT INTO \"returning\" VALUES (1)"));
+  ASSERT_TRUE(IsUpdateStatement("UPDATE t SET a = 1 -- RETURNING a"));
+  ASSERT_TRUE(IsUpdateStatement("UPDATE t SET a = 1 /* RETURNING a */"));
+  ASSERT_TRUE(IsUpdateStatement("INSERT INTO t SELECT * FROM f(x RETURNING y)"));
+  ASSERT_TRUE(IsUpdateStatement("UPDATE t SET a = $$ returning $$"));
+  // Nor do columns named like them.
+  ASSERT_TRUE(IsUpdateStatement("UPDATE t SET output = 1"));
+  ASSERT_TRUE(IsUpdateStatement("UPDATE t SET t.returning = 1"));
+  ASSERT_TRUE(IsUpdateStatement("UPDATE t SET returning_rows = 1"));
+}
+
+TEST(Utils, SplitStatements) {
+  ASSERT_EQ(std::vector<std::string>({"SELECT 1"}), SplitStatements("SELECT 1"));
+  ASSERT_EQ(std::vector<std::string>({"SELECT 1"}), SplitStatements("SELECT 1;  "));
+  ASSERT_EQ(std::vector<std::string>({"SELECT 1", " INSERT INTO t VALUES (2)"}),
+            SplitStatements("SELECT 1; INSERT INTO t VALUES (2)"));
+  ASSERT_EQ(std::vector<std::string>({"SELECT ';', \"a;b\" FROM t", " SELECT 'it''s;'"}),
+            SplitStatements("SELECT ';', \"a;b\" FROM t; SELECT 'it''s;'"));
+  ASSERT_EQ(std::vector<std::string>({"SELECT 1 -- one;\n", " /* two; */ SELECT 2"}),
+            SplitStatements("SELECT 1 -- one;\n; /* two; */ SELECT 2"));
+  ASSERT_EQ(std::vector<std::string>({"SELECT 1"}), SplitStatements("SELECT 1; -- trailing comment"));
+  ASSERT_TRUE(SplitStatements(" ; ").empty());
+}
+
+TEST(Utils, SplitStatementsKeepsBodiesTogether) {
+  ASSERT_EQ(std::vector<std::string>({"CREATE PROCEDURE p() BEGIN SELECT 1; SELECT 2; END", " SELECT 3"}),
+            SplitStatements("CREATE PROCEDURE p() BEGIN SELECT 1; SELECT 2; END; SELECT 3"));
+  ASSERT_EQ(std::vector<std::string>({"BEGIN IF a THEN SELECT 1; END IF; END", " SELECT 2"}),
+            SplitStatements("BEGIN IF a THEN SELECT 1; END IF; END; SELECT 2"));
+  ASSERT_EQ(std::vector<std::string>({"SELECT CASE WHEN a THEN 1 END", " SELECT 2"}),
+            SplitStatements("SELECT CASE WHEN a THEN 1 END; SELECT 2"));
+  ASSERT_EQ(std::vector<std::string>({"BEGIN", " SELECT 1", " COMMIT"}),
+            SplitStatements("BEGIN; SELECT 1; COMMIT"));
+  ASSERT_EQ(std::vector<std::string>({"CREATE FUNCTION f() AS $$ SELECT 1; $$", " SELECT 2"}),
+            SplitStatements("CREATE FUNCTION f() AS $$ SELECT 1; $$; SELECT 2"));
+  ASSERT_EQ(std::vector<std::string>({"CREATE FUNCTION f() AS $body$ SELECT '$$;' $body$"}),
+            SplitStatements("CREATE FUNCTION f() AS $body$ SELECT '$$;' $body$"));
+  ASSERT_EQ(std::vector<std::string>({"SELECT $1", " SELECT 2"}), SplitStatements("SELECT $1; SELECT 2"));
+  ASSERT_EQ(std::vector<std::string>({"SELECT 'a\\';b'", " SELECT 2"}),
+            SplitStatements("SELECT 'a\\';b'; SELECT 2"));
+  ASSERT_EQ(std::vector<std::string>({"SELECT 'a; SELECT 2"}), SplitStatements("SELECT 'a; SELECT 2"));
+}
+
 TEST(Utils, ConvertToDBMSVer) {
   ASSERT_EQ(std::string("01.02.0003"), ConvertToDBMSVer("1.2.3"));
   ASSERT_EQ(std::string("01.02.0003.0"), ConvertToDBMSVer("1.2.3.0"));
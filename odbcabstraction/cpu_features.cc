@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#include <odbcabstraction/cpu_features.h>
+
+#include <algorithm>
+#include <atomic>
+#include <boost/algorithm/string/predicate.hpp>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace driver {
+namespace odbcabstraction {
+
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+SimdLevel DetectSimdLevel() {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  const int max_leaf = info[0];
+
+  __cpuid(info, 1);
+  const bool sse4_2 = (info[2] & (1 << 20)) != 0;
+  const bool os_xsave = (info[2] & (1 << 27)) != 0;
+
+  // The OS must save the AVX (YMM) and AVX-512 (opmask, ZMM) registers.
+  const uint64_t xcr0 = os_xsave ? _xgetbv(0) : 0;
+  const bool os_avx = (xcr0 & 0x6) == 0x6;
+  const bool os_avx512 = (xcr0 & 0xe6) == 0xe6;
+
+  bool avx2 = false;
+  bool avx512 = false;
+  if (max_leaf >= 7) {
+    __cpuidex(info, 7, 0);
+    avx2 = os_avx && (info[1] & (1 << 5)) != 0;
+    // Foundation and byte/word instructions.
+    avx512 = os_avx512 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+  }
+#else
+  __builtin_cpu_init();
+  const bool sse4_2 = __builtin_cpu_supports("sse4.2");
+  const bool avx2 = __builtin_cpu_supports("avx2");
+  const bool avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+
+  if (avx512 && avx2 && sse4_2) return SimdLevel_AVX512;
+  if (avx2 && sse4_2) return SimdLevel_AVX2;
+  if (sse4_2) return SimdLevel_SSE4_2;
+  return SimdLevel_NONE;
+}
+#elif defined(__aarch64__) || defined(_M_ARM64)
+SimdLevel DetectSimdLevel() {
+  // NEON is part of the base AArch64 instruction set.
+  return SimdLevel_NEON;
+}
+#else
+SimdLevel DetectSimdLevel() {
+  return SimdLevel_NONE;
+}
+#endif
+
+/// Lowers a tier to one the host supports.
+SimdLevel ClampToDetected(SimdLevel level) {
+  const SimdLevel detected = GetDetectedSimdLevel();
+  if (detected == SimdLevel_NEON || level == SimdLevel_NEON) {
+    return level == detected ? level : SimdLevel_NONE;
+  }
+  return std::min(level, detected);
+}
+
+int ReadMaxSimdLevelFromEnvironment() {
+  const char *env_p = std::getenv(SIMD_LEVEL_ENV_VAR);
+  if (env_p) {
+    boost::optional<SimdLevel> level = ParseSimdLevel(env_p);
+    if (level) {
+      return *level;
+    }
+  }
+  return -1;
+}
+
+std::atomic<int> &MaxSimdLevel() {
+  // -1 when not capped.
+  static std::atomic<int> max_level(ReadMaxSimdLevelFromEnvironment());
+  return max_level;
+}
+
+} // namespace
+
+SimdLevel GetDetectedSimdLevel() {
+  static const SimdLevel detected = DetectSimdLevel();
+  return detected;
+}
+
+SimdLevel GetSimdLevel() {
+  const int max_level = MaxSimdLevel().load();
+  if (max_level < 0) {
+    return GetDetectedSimdLevel();
+  }
+  return ClampToDetected(static_cast<SimdLevel>(max_level));
+}
+
+void SetMaxSimdLevel(SimdLevel level) {
+  MaxSimdLevel().store(level);
+}
+
+bool IsSimdLevelEnabled(SimdLevel level) {
+  if (level == SimdLevel_NONE) {
+    return true;
+  }
+
+  const SimdLevel enabled = GetSimdLevel();
+  if (enabled == SimdLevel_NEON || level == SimdLevel_NEON) {
+    return level == enabled;
+  }
+  return level <= enabled;
+}
+
+boost::optional<SimdLevel> ParseSimdLevel(const std::string &value) {
+  if (boost::iequals(value, "none")) return SimdLevel_NONE;
+  if (boost::iequals(value, "sse4.2") || boost::iequals(value, "sse4_2")) return SimdLevel_SSE4_2;
+  if (boost::iequals(value, "avx2")) return SimdLevel_AVX2;
+  if (boost::iequals(value, "avx512")) return SimdLevel_AVX512;
+  if (boost::iequals(value, "neon")) return SimdLevel_NEON;
+  return boost::none;
+}
+
+std::string SimdLevelToString(SimdLevel level) {
+  switch (level) {
+    case SimdLevel_NONE:
+      return "none";
+    case SimdLevel_SSE4_2:
+      return "sse4.2";
+    case SimdLevel_AVX2:
+      return "avx2";
+    case SimdLevel_AVX512:
+      return "avx512";
+    case SimdLevel_NEON:
+      return "neon";
+  }
+  return "unknown";
+}
+
+} // namespace odbcabstraction
+} // namespace driver
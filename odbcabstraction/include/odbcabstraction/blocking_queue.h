@@ -27,6 +27,7 @@ class BlockingQueue {
   size_t buffer_size_{0};
   size_t left_{0}; // index where variables are put inside of buffer (produced)
   size_t right_{0}; // index where variables are removed from buffer (consumed)
+  size_t pending_{0}; // slots reserved by producers still running their supplier
 
   std::mutex mtx_;
   std::condition_variable not_empty_;
@@ -53,15 +54,25 @@ public:
     active_threads_++;
     threads_.emplace_back([=] {
       while (!closed_) {
-        // Block while queue is full
+        // Block while queue is full, then reserve a slot for the next item
         std::unique_lock<std::mutex> unique_lock(mtx_);
         if (!WaitUntilCanPushOrClosed(unique_lock)) break;
+        pending_++;
 
-        // Only one thread at a time be notified and call supplier
+        // Suppliers may take long to produce an item (e.g. reading and decoding
+        // a record batch), so they run without the lock. This lets producers
+        // work in parallel and consumers pop items meanwhile.
+        unique_lock.unlock();
         auto item = supplier();
-        if (!item) break;
+        unique_lock.lock();
 
-        Push(*item);
+        pending_--;
+        if (!item || closed_) {
+          not_full_.notify_one();
+          break;
+        }
+
+        Push(std::move(*item));
         not_empty_.notify_one();
       }
 
@@ -111,19 +122,17 @@ private:
   }
 
   bool WaitUntilCanPushOrClosed(std::unique_lock<std::mutex> &unique_lock) {
-    if (extended_capacity_ > 0 && buffer_size_ >= extended_capacity_ ) {
-      not_full_.wait(unique_lock, [this]() {
-        return closed_ || buffer_size_ < extended_capacity_;
-      });
-    }
-    else if (extended_capacity_ > 0 && buffer_size_ >= capacity_) {
+    if (extended_capacity_ > 0 && buffer_size_ + pending_ >= capacity_ &&
+        buffer_size_ + pending_ < extended_capacity_) {
       not_full_.wait_for(unique_lock, std::chrono::milliseconds(500));
     }
-    else {
-      not_full_.wait(unique_lock, [this]() {
-        return closed_ || buffer_size_ < capacity_;
-      });
-    }
+
+    // Other producers may have reserved slots meanwhile, so check the limit
+    // again before returning.
+    size_t limit = extended_capacity_ > 0 ? extended_capacity_ : capacity_;
+    not_full_.wait(unique_lock, [this, limit]() {
+      return closed_ || buffer_size_ + pending_ < limit;
+    });
 
     return !closed_;
   }
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020-2022 Dremio Corporation
+ *
+ * See "LICENSE" for license information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <boost/optional.hpp>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace driver {
+namespace odbcabstraction {
+
+/// \brief Instruction set tiers conversion kernels can be specialized for.
+/// x86 tiers are ordered by capability, each implying the previous ones.
+enum SimdLevel {
+  SimdLevel_NONE = 0,
+  SimdLevel_SSE4_2 = 1,
+  SimdLevel_AVX2 = 2,
+  SimdLevel_AVX512 = 3,
+  SimdLevel_NEON = 4,
+};
+
+/// Environment variable forcing a lower tier than the detected one, mostly for
+/// benchmarking. Takes the same values as \link ParseSimdLevel \endlink.
+constexpr const char *SIMD_LEVEL_ENV_VAR = "FLIGHT_SQL_ODBC_SIMD_LEVEL";
+
+/// \brief Returns the highest tier supported by the host, detected once.
+SimdLevel GetDetectedSimdLevel();
+
+/// \brief Returns the tier kernels should use: the detected one, capped by
+/// \link SetMaxSimdLevel \endlink or the SIMD_LEVEL_ENV_VAR variable.
+SimdLevel GetSimdLevel();
+
+/// \brief Caps the tier kernels use, for the whole process. Tiers the host
+/// doesn't support are never enabled.
+void SetMaxSimdLevel(SimdLevel level);
+
+/// \brief Returns true if kernels written for the given tier can be used.
+bool IsSimdLevelEnabled(SimdLevel level);
+
+/// \brief Parses a tier name: "none", "sse4.2", "avx2", "avx512" or "neon",
+/// ignoring case.
+boost::optional<SimdLevel> ParseSimdLevel(const std::string &value);
+
+/// \brief Returns the name of a tier, as accepted by ParseSimdLevel.
+std::string SimdLevelToString(SimdLevel level);
+
+/// \brief Picks the best implementation of a kernel for the enabled tier.
+///
+/// Implementations for tiers above SimdLevel_NONE must be compiled for that
+/// tier only, e.g. with `__attribute__((target("avx2")))`, so the rest of the
+/// binary keeps running on any host. A SimdLevel_NONE implementation must
+/// always be given.
+template <typename FUNCTION>
+class KernelDispatcher {
+public:
+  KernelDispatcher(std::initializer_list<std::pair<SimdLevel, FUNCTION>> implementations)
+      : implementations_(implementations), resolved_(-1) {}
+
+  /// \brief Returns the implementation for the highest enabled tier. It is
+  /// only looked up again when the enabled tier changed.
+  FUNCTION Get() const {
+    const int level = GetSimdLevel();
+    int resolved = resolved_.load(std::memory_order_relaxed);
+    if (resolved < 0 || resolved / RESOLVED_LEVEL_FACTOR != level) {
+      resolved = level * RESOLVED_LEVEL_FACTOR + static_cast<int>(Resolve());
+      resolved_.store(resolved, std::memory_order_relaxed);
+    }
+    return implementations_[resolved % RESOLVED_LEVEL_FACTOR].second;
+  }
+
+private:
+  // The tier and the index of its implementation are kept in a single value,
+  // so they are always read together.
+  static constexpr int RESOLVED_LEVEL_FACTOR = 256;
+
+  /// \brief Returns the index of the implementation for the highest enabled
+  /// tier.
+  size_t Resolve() const {
+    size_t result = 0;
+    bool found = false;
+    for (size_t i = 0; i < implementations_.size(); ++i) {
+      if (IsSimdLevelEnabled(implementations_[i].first) &&
+          (!found || implementations_[i].first > implementations_[result].first)) {
+        result = i;
+        found = true;
+      }
+    }
+    return result;
+  }
+
+  std::vector<std::pair<SimdLevel, FUNCTION>> implementations_;
+  // -1 until the first lookup.
+  mutable std::atomic<int> resolved_;
+};
+
+} // namespace odbcabstraction
+} // namespace driver
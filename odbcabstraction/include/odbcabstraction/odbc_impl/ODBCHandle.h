@@ -74,6 +74,30 @@ public:
     }
   }
 
+  /**
+   * @brief Runs a function that must not wait for other functions running on the
+   * handle, such as SQLCancel. The handle lock is taken when it is free. Otherwise
+   * the function runs without it and without touching the diagnostics, which
+   * belong to the thread holding the lock.
+   */
+  template <typename Function>
+  static inline SQLRETURN ExecuteWithoutBlocking(SQLHANDLE handle, SQLRETURN rc, Function func) {
+    if (!handle) {
+      return SQL_INVALID_HANDLE;
+    }
+    ODBCHandle* odbcHandle = reinterpret_cast<Derived*>(handle);
+    std::unique_lock<std::mutex> lock(odbcHandle->mtx_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      return odbcHandle->execute(rc, func);
+    }
+
+    try {
+      return func();
+    } catch (...) {
+      return SQL_ERROR;
+    }
+  }
+
   static Derived* of(SQLHANDLE handle) {
     return reinterpret_cast<Derived*>(handle);
   }
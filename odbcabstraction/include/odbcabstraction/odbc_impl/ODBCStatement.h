@@ -10,13 +10,20 @@
 
 #include <odbcabstraction/platform.h>
 #include <sql.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace driver {
 namespace odbcabstraction {
   class Statement;
   class ResultSet;
+  class ResultSetMetadata;
+  struct ParameterBinding;
 }
 }
 
@@ -55,8 +62,32 @@ class ODBCStatement : public ODBCHandle<ODBCStatement> {
      * @brief Returns true if the number of rows fetch was greater than zero.
      */
     bool Fetch(size_t rows);
+
+    /**
+     * @brief Fetches the rowset at the given position. Forward-only cursors
+     * only support SQL_FETCH_NEXT and forward SQL_FETCH_RELATIVE offsets, with
+     * rows in between skipped without being converted. Static cursors support
+     * every orientation but SQL_FETCH_BOOKMARK.
+     */
+    bool FetchScroll(SQLSMALLINT orientation, SQLLEN offset, size_t rows);
     bool isPrepared() const;
 
+    /**
+     * @brief Returns true while an asynchronous execution started by ExecuteDirect,
+     * ExecutePrepared or a catalog function has not completed. The application
+     * polls by calling the same function again, which should then report
+     * SQL_STILL_EXECUTING.
+     */
+    inline bool IsStillExecuting() const {
+      return m_asyncExecution.valid();
+    }
+
+    /**
+     * @brief Returns the number of rows affected by the last update, or -1 if
+     * the statement produced a result set.
+     */
+    SQLLEN GetRowCount();
+
     void GetStmtAttr(SQLINTEGER statementAttribute, SQLPOINTER output,
                      SQLINTEGER bufferSize, SQLINTEGER *strLenPtr, bool isUnicode);
     void SetStmtAttr(SQLINTEGER statementAttribute, SQLPOINTER value,
@@ -64,9 +95,11 @@ class ODBCStatement : public ODBCHandle<ODBCStatement> {
 
     void RevertAppDescriptor(bool isApd);
 
-    inline ODBCDescriptor* GetIRD() {
-      return m_ird.get();
-    }
+    /**
+     * @brief Returns the IRD, preparing a deferred query on the server first so
+     * the IRD describes its columns.
+     */
+    ODBCDescriptor* GetIRD();
 
     inline ODBCDescriptor* GetARD() {
       return m_currentArd;
@@ -84,6 +117,12 @@ class ODBCStatement : public ODBCHandle<ODBCStatement> {
      */
     void closeCursor(bool suppressErrors);
 
+    /**
+     * @brief Closes the cursor and moves to the next result of a batch.
+     * @return false if there are no more results.
+     */
+    bool MoreResults();
+
     /**
      * @brief Releases this statement from memory.
      */
@@ -95,9 +134,82 @@ class ODBCStatement : public ODBCHandle<ODBCStatement> {
     void GetForeignKeys(const std::string* pkCatalog, const std::string* pkSchema, const std::string* pkTable,
                         const std::string* fkCatalog, const std::string* fkSchema, const std::string* fkTable);
     void GetPrimaryKeys(const std::string* catalog, const std::string* schema, const std::string* table);
+
+    /**
+     * @brief Cancels the statement's result stream, and an asynchronous execution
+     * in progress, which then reports HY008 once polled to completion. Safe to
+     * call from another thread while the statement is in use, see
+     * ODBCHandle::ExecuteWithoutBlocking.
+     */
     void Cancel();
 
   private:
+    /**
+     * @brief The outcome of a server prepare run by an execution, possibly on
+     * an asynchronous worker.
+     */
+    struct PendingPrepare {
+      bool succeeded = false;
+      boost::optional<std::shared_ptr<driver::odbcabstraction::ResultSetMetadata> > metadata;
+    };
+
+    /**
+     * @brief Reads the parameters bound on the APD, which are sent to the
+     * prepared statement on execution. Returns the number of parameter sets.
+     */
+    SQLULEN GetParameterBindings(std::vector<driver::odbcabstraction::ParameterBinding>& bindings);
+
+    /**
+     * @brief Prepares the query on the server if SQLPrepare deferred it, and
+     * populates the IRD from its metadata.
+     */
+    void EnsurePrepared();
+
+    /**
+     * @brief Takes the outcome of the server prepare run by the last
+     * ExecutePrepared once it completed, and populates the IRD from its
+     * metadata unless the execution returned a result set.
+     */
+    void CompletePendingPrepare();
+
+    bool HasBoundParameters() const;
+
+    /**
+     * @brief Reports the outcome of the parameter sets of the last ExecutePrepared
+     * in the IPD. The sets from succeeded to processed failed, and the ones after
+     * were not executed.
+     */
+    void SetParamsetStatuses(SQLULEN succeeded, SQLULEN processed);
+
+    /**
+     * @brief Positions a static cursor and fetches the rowset there.
+     */
+    bool FetchStatic(SQLSMALLINT orientation, SQLLEN offset, size_t rows);
+
+    /**
+     * @brief Returns the number of rows of the current result of a static
+     * cursor, reading it to its end.
+     */
+    SQLLEN CountResultRows();
+
+    void SetCursorType(SQLULEN cursorType);
+
+    /**
+     * @brief Runs the execution inline, or on a worker when SQL_ATTR_ASYNC_ENABLE
+     * is on, and makes its result the current cursor. Returns false while the
+     * asynchronous execution is still in progress.
+     * @param function The SQL_API_* identifier of the calling function. Polls
+     * must come through the function that started the execution.
+     */
+    bool RunExecution(SQLUSMALLINT function,
+                      const std::function<std::shared_ptr<driver::odbcabstraction::ResultSet>()>& execution);
+
+    /**
+     * @brief Throws a function sequence error while an asynchronous execution
+     * is in progress.
+     */
+    void CheckNotExecuting() const;
+
     ODBCConnection& m_connection;
     std::shared_ptr<driver::odbcabstraction::Statement> m_spiStatement;
     std::shared_ptr<driver::odbcabstraction::ResultSet> m_currenResult;
@@ -111,8 +223,20 @@ class ODBCStatement : public ODBCHandle<ODBCStatement> {
     ODBCDescriptor* m_currentApd;
     SQLULEN m_rowNumber;
     SQLULEN m_maxRows;
+    SQLULEN m_cursorType;
     SQLULEN m_rowsetSize; // Used by SQLExtendedFetch instead of the ARD array size.
+    SQLULEN m_lastFetchedRows; // Size of the current rowset.
+    SQLULEN m_retrieveData;
+    SQLULEN m_asyncEnable;
+    SQLULEN m_paramsetSize; // Parameter sets sent by the last ExecutePrepared.
+    std::future<std::shared_ptr<driver::odbcabstraction::ResultSet>> m_asyncExecution;
+    SQLUSMALLINT m_asyncFunction; // The function that started m_asyncExecution.
+    std::atomic<bool> m_asyncCancelled; // Set by Cancel, possibly from another thread.
+    std::string m_preparedQuery;
     bool m_isPrepared;
+    bool m_needsServerPrepare; // SQLPrepare was called but the server has not prepared the query yet.
+    std::shared_ptr<PendingPrepare> m_pendingPrepare; // The server prepare run by the current ExecutePrepared.
+    bool m_hasExecutedPrepared; // SQLExecute was called since the last SQLPrepare.
     bool m_hasReachedEndOfResult;
 };
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <map>
 #include <memory>
 
@@ -13,6 +14,8 @@
 
 #include <odbcabstraction/types.h>
 
+struct ArrowArrayStream;
+
 namespace driver {
 namespace odbcabstraction {
 
@@ -65,6 +68,26 @@ public:
   /// \returns The number of rows fetched.
   virtual size_t Move(size_t rows, size_t bind_offset, size_t bind_type, uint16_t *row_status_array) = 0;
 
+  /// \brief Advances over the next rows without loading any values on bound
+  /// buffers. Only row statuses are reported.
+  ///
+  /// \param rows The maximum number of rows to be skipped.
+  /// \param row_status_array The array to write statuses.
+  /// \returns The number of rows skipped.
+  virtual size_t Skip(size_t rows, uint16_t *row_status_array) = 0;
+
+  /// \brief Positions a scrollable ResultSet so the next call to `Move()`
+  /// starts at the given row. Only valid when the statement was executed with
+  /// the SCROLLABLE attribute set.
+  ///
+  /// \param row The row to position on, starting from 0.
+  /// \returns false if the ResultSet has fewer rows.
+  virtual bool Seek(size_t row) = 0;
+
+  /// \brief Reads a scrollable ResultSet to its end and returns its number of
+  /// rows. The position of the cursor does not change.
+  virtual size_t CountRows() = 0;
+
   /// \brief Populates `buffer` with the value on current row for given column.
   /// If the value doesn't fit the buffer this method returns true and
   /// subsequent calls will fetch the rest of data.
@@ -81,6 +104,21 @@ public:
   virtual bool GetData(int column, int16_t target_type, int precision,
                        int scale, void *buffer, size_t buffer_length,
                        ssize_t *strlen_buffer) = 0;
+
+  /// \brief Exports the rows not fetched yet as an Arrow C stream, so they can
+  /// be consumed without going through bound buffers. Subsequent calls to
+  /// `Move()` fetch no rows.
+  ///
+  /// The stream reads from this ResultSet. If it gets closed or cancelled
+  /// before its rows were all read, the stream fails with a cancellation error
+  /// rather than ending with rows missing.
+  ///
+  /// \param out The stream to be populated. The caller owns it afterwards and
+  ///            must call its release callback.
+  /// \param max_rows The number of rows the stream ends after, e.g. what is
+  ///                 left of SQL_ATTR_MAX_ROWS. No limit if empty.
+  virtual void ExportArrowStream(struct ArrowArrayStream *out,
+                                 boost::optional<size_t> max_rows) = 0;
 };
 
 } // namespace odbcabstraction
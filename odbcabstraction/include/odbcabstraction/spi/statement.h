@@ -11,6 +11,8 @@
 #include <map>
 #include <vector>
 
+#include <odbcabstraction/platform.h>
+
 namespace driver {
 namespace odbcabstraction {
 
@@ -20,6 +22,16 @@ class ResultSet;
 
 class ResultSetMetadata;
 
+/// \brief Application buffers bound to a statement parameter.
+struct ParameterBinding {
+  int16_t c_type;         // C data type of the bound values.
+  int precision;          // Precision, for numeric values.
+  int scale;              // Scale, for numeric values.
+  void *buffer;           // Values of the first parameter set.
+  ssize_t buffer_length;  // Length of each value, for character and binary data.
+  ssize_t *strlen_buffer; // Length or null indicators. May be null.
+};
+
 /// \brief High-level representation of an ODBC statement.
 class Statement {
 protected:
@@ -35,6 +47,9 @@ public:
     METADATA_ID,    // size_t - Modifies catalog function arguments to be identifiers. SQL_TRUE or SQL_FALSE.
     NOSCAN,         // size_t - Indicates that the driver does not scan for escape sequences. Default to SQL_NOSCAN_OFF
     QUERY_TIMEOUT,  // size_t - The time to wait in seconds for queries to execute. 0 to have no timeout.
+    UPDATE_HINT,    // size_t - How statements are executed, as an UpdateHint. Defaults to UpdateHint_AUTO.
+    MAX_ROWS,       // size_t - The maximum number of rows to return in a result set. 0 means no limit.
+    SCROLLABLE,     // size_t - Whether result sets can be positioned on any row, see ResultSet::Seek(). Defaults to 0.
   };
 
   typedef boost::variant<size_t> Attribute;
@@ -75,20 +90,62 @@ public:
   ///         false if it is an update count or there are no results.
   virtual bool ExecutePrepared() = 0;
 
+  /// \brief Sets the parameter values used by the next executions of the
+  /// prepared statement, one row per parameter set.
+  ///
+  /// NOTE: Must call `Prepare(const std::string &query)` before. Bound buffers
+  /// may be referenced without being copied, so they must stay valid until
+  /// the statement is executed.
+  ///
+  /// \param bindings The buffers bound to each parameter, in order. Empty to
+  ///                 clear the parameters.
+  /// \param paramset_size The number of parameter sets.
+  /// \param bind_offset The offset for bound buffers and indicators.
+  /// \param bind_type Zero for column-wise binding, otherwise the size of an
+  ///                  application row buffer. Same as SQL_DESC_BIND_TYPE.
+  virtual void SetParameters(const std::vector<ParameterBinding> &bindings,
+                             size_t paramset_size, size_t bind_offset,
+                             size_t bind_type) = 0;
+
   /// \brief Execute the statement if it is prepared or not.
   /// \param query The SQL query to execute.
   /// \returns true if the first result is a ResultSet object;
   ///         false if it is an update count or there are no results.
   virtual bool Execute(const std::string &query) = 0;
 
+  /// \brief Execute the query as a single statement, without preparing it.
+  /// Unlike Execute(), the query is never split into a batch nor counted
+  /// towards preparing it later, e.g. for a prepared statement that was not
+  /// sent to the server yet.
+  /// \param query The SQL query to execute.
+  /// \returns true if the result is a ResultSet object;
+  ///         false if it is an update count.
+  virtual bool ExecuteSingle(const std::string &query) = 0;
+
   /// \brief Returns the current result as a ResultSet object.
   virtual std::shared_ptr<ResultSet> GetResultSet() = 0;
 
+  /// \brief Moves to the next result when the executed query was a batch of
+  /// statements, closing the current result set.
+  /// \returns true if there is another result, which is then returned by
+  ///          GetResultSet(), or by GetUpdateCount() if it is an update count;
+  ///          false if there are no more results.
+  virtual bool MoreResults() = 0;
+
   /// \brief Retrieves the current result as an update count;
   /// if the result is a ResultSet object or there are no more results, -1 is
   /// returned.
   virtual long GetUpdateCount() = 0;
 
+  /// \brief Returns the number of parameter sets the last execution sent to
+  /// the server, including those of a failed call.
+  virtual size_t GetParamsetsProcessed() = 0;
+
+  /// \brief Returns how many of the processed parameter sets were applied.
+  /// Parameter sets may be sent in several calls, so when one fails, those
+  /// sent by the calls before it are still applied.
+  virtual size_t GetParamsetsSucceeded() = 0;
+
   /// \brief Returns the list of table, catalog, or schema names, and table
   /// types, stored in a specific data source. The driver returns the
   /// information as a result set.
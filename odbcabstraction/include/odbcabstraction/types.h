@@ -95,6 +95,27 @@ enum CDataType {
   CDataType_BINARY = (-2),
   CDataType_NUMERIC = 2,
   CDataType_DEFAULT = 99,
+  // Driver-specific types, starting at SQL_DRIVER_C_TYPE_BASE.
+  CDataType_STRING_VIEW = 0x4000,
+};
+
+// Driver-specific statement attributes, starting at SQL_DRIVER_STMT_ATTR_BASE.
+enum StatementAttribute {
+  // Read-only. SQLGetStmtAttr exports the current result set into the
+  // `struct ArrowArrayStream` pointed to by the value pointer.
+  StatementAttribute_ARROW_ARRAY_STREAM = 0x4000,
+  // An UpdateHint value telling how statements are executed.
+  StatementAttribute_UPDATE_HINT = 0x4001,
+};
+
+// Values of StatementAttribute_UPDATE_HINT.
+enum UpdateHint {
+  // Statements whose leading keyword is a DML one are executed as updates.
+  UpdateHint_AUTO = 0,
+  // Statements are always executed as queries returning a result set.
+  UpdateHint_QUERY = 1,
+  // Statements are always executed as updates returning a row count.
+  UpdateHint_UPDATE = 2,
 };
 
 enum Nullability {
@@ -156,6 +177,17 @@ typedef struct tagNUMERIC_STRUCT {
   uint8_t val[16]; //[e], [f]
 } NUMERIC_STRUCT;
 
+/// \brief Value of the driver-specific CDataType_STRING_VIEW C type.
+///
+/// Points at the bytes of a string or binary value in the result set's memory
+/// instead of copying them. The value is not null terminated and stays valid
+/// until the next fetch or until the cursor is closed.
+typedef struct tagSTRING_VIEW_STRUCT
+{
+  const char *data;
+  int64_t length;
+} STRING_VIEW_STRUCT;
+
 enum RowStatus: uint16_t {
   RowStatus_SUCCESS = 0,  // Same as SQL_ROW_SUCCESS
   RowStatus_SUCCESS_WITH_INFO = 6,  // Same as SQL_ROW_SUCCESS_WITH_INFO
@@ -168,7 +200,10 @@ struct MetadataSettings {
   size_t chunk_buffer_capacity_;
   bool use_wide_char_;
   bool use_extended_flightsql_buffer_;
+  size_t spill_threshold_{0}; // Bytes of results held in memory before spilling to disk. 0 never spills.
+  bool split_statement_batches_{false}; // Whether the driver runs the statements of a batch one by one.
   bool hide_sql_tables_listing_;
+  bool flatten_struct_columns_;
 };
 
 } // namespace odbcabstraction
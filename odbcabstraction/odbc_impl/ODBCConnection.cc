@@ -130,19 +130,13 @@ void ODBCConnection::GetInfo(SQLUSMALLINT infoType, SQLPOINTER value, SQLSMALLIN
       break;
     #endif
     case SQL_ASYNC_MODE:
-      GetAttribute(static_cast<SQLUINTEGER>(SQL_AM_NONE), value, bufferLength, outputLength);
+      GetAttribute(static_cast<SQLUINTEGER>(SQL_AM_STATEMENT), value, bufferLength, outputLength);
       break;
     #ifdef SQL_ASYNC_NOTIFICATION
     case SQL_ASYNC_NOTIFICATION:
       GetAttribute(static_cast<SQLUINTEGER>(SQL_ASYNC_NOTIFICATION_NOT_CAPABLE), value, bufferLength, outputLength);
       break;
     #endif
-    case SQL_BATCH_ROW_COUNT:
-      GetAttribute(static_cast<SQLUINTEGER>(0), value, bufferLength, outputLength);
-      break;
-    case SQL_BATCH_SUPPORT:
-      GetAttribute(static_cast<SQLUINTEGER>(0), value, bufferLength, outputLength);
-      break;
     case SQL_DATA_SOURCE_NAME:
       GetStringAttribute(isUnicode, m_dsn, true, value, bufferLength, outputLength, GetDiagnostics());
       break;
@@ -188,13 +182,14 @@ void ODBCConnection::GetInfo(SQLUSMALLINT infoType, SQLPOINTER value, SQLSMALLIN
       GetStringAttribute(isUnicode, "N", true, value, bufferLength, outputLength, GetDiagnostics());
       break;
     case SQL_SCROLL_OPTIONS:
-      GetAttribute(static_cast<SQLUINTEGER>(SQL_SO_FORWARD_ONLY), value, bufferLength, outputLength);
+      GetAttribute(static_cast<SQLUINTEGER>(SQL_SO_FORWARD_ONLY | SQL_SO_STATIC), value, bufferLength, outputLength);
       break;
     case SQL_STATIC_CURSOR_ATTRIBUTES1:
-      GetAttribute(static_cast<SQLUINTEGER>(0), value, bufferLength, outputLength);
+      GetAttribute(static_cast<SQLUINTEGER>(SQL_CA1_NEXT | SQL_CA1_ABSOLUTE | SQL_CA1_RELATIVE), value, bufferLength,
+                   outputLength);
       break;
     case SQL_STATIC_CURSOR_ATTRIBUTES2:
-      GetAttribute(static_cast<SQLUINTEGER>(0), value, bufferLength, outputLength);
+      GetAttribute(static_cast<SQLUINTEGER>(SQL_CA2_READ_ONLY_CONCURRENCY), value, bufferLength, outputLength);
       break;
     case SQL_BOOKMARK_PERSISTENCE:
       GetAttribute(static_cast<SQLUINTEGER>(0), value, bufferLength, outputLength);
@@ -202,9 +197,6 @@ void ODBCConnection::GetInfo(SQLUSMALLINT infoType, SQLPOINTER value, SQLSMALLIN
     case SQL_DESCRIBE_PARAMETER:
       GetStringAttribute(isUnicode, "N", true, value, bufferLength, outputLength, GetDiagnostics());
       break;
-    case SQL_MULT_RESULT_SETS:
-      GetStringAttribute(isUnicode, "N", true, value, bufferLength, outputLength, GetDiagnostics());
-      break;
     case SQL_MULTIPLE_ACTIVE_TXN:
       GetStringAttribute(isUnicode, "N", true, value, bufferLength, outputLength, GetDiagnostics());
       break;
@@ -272,6 +264,7 @@ void ODBCConnection::GetInfo(SQLUSMALLINT infoType, SQLPOINTER value, SQLSMALLIN
     case SQL_PROCEDURES:
     case SQL_SPECIAL_CHARACTERS:
     case SQL_XOPEN_CLI_YEAR:
+    case SQL_MULT_RESULT_SETS:
     {
       const auto& info = m_spiConnection->GetInfo(infoType);
       const std::string& infoValue = boost::get<std::string>(info);
@@ -281,6 +274,8 @@ void ODBCConnection::GetInfo(SQLUSMALLINT infoType, SQLPOINTER value, SQLSMALLIN
 
     // Driver-level 32-bit integer properties.
     case SQL_GETDATA_EXTENSIONS:
+    case SQL_BATCH_ROW_COUNT:
+    case SQL_BATCH_SUPPORT:
     case SQL_INFO_SCHEMA_VIEWS:
     case SQL_CURSOR_SENSITIVITY:
     case SQL_DEFAULT_TXN_ISOLATION:
@@ -19,6 +19,8 @@
 #include <odbcabstraction/spi/result_set_metadata.h>
 #include <odbcabstraction/types.h>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <chrono>
 #include <utility>
 #include <boost/variant.hpp>
 
@@ -26,6 +28,14 @@ using namespace ODBC;
 using namespace driver::odbcabstraction;
 
 namespace {
+  boost::optional<std::string> CopyArgument(const std::string* value) {
+    return value ? boost::make_optional(*value) : boost::none;
+  }
+
+  const std::string* ArgumentPtr(const boost::optional<std::string>& value) {
+    return value ? &*value : nullptr;
+  }
+
   void DescriptorToHandle(SQLPOINTER output, ODBCDescriptor* descriptor, SQLINTEGER* lenPtr) {
     if (output) {
       SQLHANDLE* outputHandle = static_cast<SQLHANDLE*>(output);
@@ -94,6 +104,9 @@ namespace {
       case SQL_C_INTERVAL_YEAR_TO_MONTH:
       case SQL_C_INTERVAL_MONTH:
         return sizeof(SQL_INTERVAL_STRUCT);
+
+      case CDataType_STRING_VIEW:
+        return sizeof(STRING_VIEW_STRUCT);
       default:
         return record.m_length;
     }
@@ -197,12 +210,21 @@ ODBCStatement::ODBCStatement(ODBCConnection& connection,
   m_builtInApd(std::make_shared<ODBCDescriptor>(m_spiStatement->GetDiagnostics(), nullptr, this, true, true, connection.IsOdbc2Connection())),
   m_ipd(std::make_shared<ODBCDescriptor>(m_spiStatement->GetDiagnostics(), nullptr, this, false, true, connection.IsOdbc2Connection())),
   m_ird(std::make_shared<ODBCDescriptor>(m_spiStatement->GetDiagnostics(), nullptr, this, false, false, connection.IsOdbc2Connection())),
-  m_currentArd(m_builtInApd.get()),
+  m_currentArd(m_builtInArd.get()),
   m_currentApd(m_builtInApd.get()),
   m_rowNumber(0),
   m_maxRows(0),
+  m_cursorType(SQL_CURSOR_FORWARD_ONLY),
   m_rowsetSize(1),
+  m_lastFetchedRows(0),
+  m_retrieveData(SQL_RD_ON),
+  m_asyncEnable(SQL_ASYNC_ENABLE_OFF),
+  m_paramsetSize(0),
+  m_asyncFunction(0),
+  m_asyncCancelled(false),
   m_isPrepared(false),
+  m_needsServerPrepare(false),
+  m_hasExecutedPrepared(false),
   m_hasReachedEndOfResult(false) {
 }
 
@@ -232,6 +254,10 @@ void ODBCStatement::CopyAttributesFromConnection(ODBCConnection& connection) {
   CopyAttribute(*trackingStatement.m_spiStatement, *m_spiStatement, Statement::MAX_LENGTH);
   CopyAttribute(*trackingStatement.m_spiStatement, *m_spiStatement, Statement::NOSCAN);
   CopyAttribute(*trackingStatement.m_spiStatement, *m_spiStatement, Statement::QUERY_TIMEOUT);
+  CopyAttribute(*trackingStatement.m_spiStatement, *m_spiStatement, Statement::MAX_ROWS);
+  m_maxRows = trackingStatement.m_maxRows;
+  CopyAttribute(*trackingStatement.m_spiStatement, *m_spiStatement, Statement::SCROLLABLE);
+  m_cursorType = trackingStatement.m_cursorType;
 
   // SQL_ATTR_ROW_BIND_TYPE:
   m_currentArd->SetHeaderField(SQL_DESC_BIND_TYPE,
@@ -243,12 +269,40 @@ bool ODBCStatement::isPrepared() const {
 }
 
 void ODBCStatement::Prepare(const std::string& query) {
-  boost::optional<std::shared_ptr<ResultSetMetadata> > metadata = m_spiStatement->Prepare(query);
+  CheckNotExecuting();
+  // The server is only asked to prepare the query once its metadata or
+  // parameters are needed, which many applications never do before executing.
+  m_preparedQuery = query;
+  m_needsServerPrepare = true;
+  m_hasExecutedPrepared = false;
+  m_isPrepared = true;
+}
+
+void ODBCStatement::EnsurePrepared() {
+  if (!m_isPrepared || !m_needsServerPrepare || IsStillExecuting()) {
+    return;
+  }
+
+  boost::optional<std::shared_ptr<ResultSetMetadata> > metadata = m_spiStatement->Prepare(m_preparedQuery);
 
   if (metadata) {
     m_ird->PopulateFromResultSetMetadata(metadata->get());
   }
-  m_isPrepared = true;
+  m_needsServerPrepare = false;
+}
+
+ODBCDescriptor* ODBCStatement::GetIRD() {
+  // Once executed, the IRD describes the result set instead.
+  if (!m_currenResult) {
+    EnsurePrepared();
+  }
+  return m_ird.get();
+}
+
+bool ODBCStatement::HasBoundParameters() const {
+  const std::vector<DescriptorRecord>& records = m_currentApd->GetRecords();
+  return std::any_of(records.begin(), records.end(),
+                     [](const DescriptorRecord& record) { return record.m_isBound; });
 }
 
 void ODBCStatement::ExecutePrepared() {
@@ -256,26 +310,183 @@ void ODBCStatement::ExecutePrepared() {
     throw DriverException("Function sequence error", "HY010");
   }
 
-  if (m_spiStatement->ExecutePrepared()) {
-    m_currenResult = m_spiStatement->GetResultSet();
-    m_ird->PopulateFromResultSetMetadata(m_spiStatement->GetResultSet()->GetMetadata().get());
-    m_hasReachedEndOfResult = false;
+  // Without parameters, the first execution of a query that was not prepared
+  // on the server yet runs in a single call and the result set describes its
+  // columns. Later executions prepare it, so they reuse the server's plan.
+  // Parameters are only read on the first call, not when polling.
+  bool executeDirectly = false;
+  std::vector<ParameterBinding> bindings;
+  size_t bindOffset = 0;
+  size_t bindType = 0;
+  if (!IsStillExecuting()) {
+    executeDirectly = m_needsServerPrepare && !m_hasExecutedPrepared && !HasBoundParameters();
+    m_hasExecutedPrepared = true;
+    m_paramsetSize = executeDirectly ? 0 : GetParameterBindings(bindings);
+    bindOffset = m_currentApd->GetBindOffset();
+    bindType = m_currentApd->GetBoundStructOffset();
+
+    // The server prepare runs along with the execution, so it does not block
+    // the application when the execution is asynchronous.
+    m_pendingPrepare.reset();
+    if (m_needsServerPrepare && !executeDirectly) {
+      m_pendingPrepare = std::make_shared<PendingPrepare>();
+    }
+  }
+
+  std::shared_ptr<Statement> spiStatement = m_spiStatement;
+  std::shared_ptr<PendingPrepare> pendingPrepare = m_pendingPrepare;
+  SQLULEN paramsetSize = m_paramsetSize;
+  std::string query = m_preparedQuery;
+  try {
+    if (!RunExecution(SQL_API_SQLEXECUTE, [=]() -> std::shared_ptr<ResultSet> {
+          if (executeDirectly) {
+            return spiStatement->ExecuteSingle(query) ? spiStatement->GetResultSet() : nullptr;
+          }
+          if (pendingPrepare) {
+            pendingPrepare->metadata = spiStatement->Prepare(query);
+            pendingPrepare->succeeded = true;
+          }
+          spiStatement->SetParameters(bindings, paramsetSize, bindOffset, bindType);
+          return spiStatement->ExecutePrepared() ? spiStatement->GetResultSet() : nullptr;
+        })) {
+      return;
+    }
+  } catch (...) {
+    // Parameter sets may be sent in several batches, and those applied before
+    // the failing one stay applied. Nothing ran if the error is about another
+    // function's execution, which is then still in progress.
+    if (!IsStillExecuting()) {
+      CompletePendingPrepare();
+      SetParamsetStatuses(m_spiStatement->GetParamsetsSucceeded(), m_spiStatement->GetParamsetsProcessed());
+    }
+    throw;
   }
+
+  CompletePendingPrepare();
+  SetParamsetStatuses(m_paramsetSize, m_paramsetSize);
 }
 
-void ODBCStatement::ExecuteDirect(const std::string& query) {
-  if (m_spiStatement->Execute(query)) {
-    m_currenResult = m_spiStatement->GetResultSet();
+void ODBCStatement::CompletePendingPrepare() {
+  std::shared_ptr<PendingPrepare> pendingPrepare;
+  pendingPrepare.swap(m_pendingPrepare);
+
+  // The prepare may have failed, or the execution been cancelled before it.
+  if (!pendingPrepare || !pendingPrepare->succeeded) {
+    return;
+  }
+  m_needsServerPrepare = false;
+
+  // A result set describes its own columns.
+  if (!m_currenResult && pendingPrepare->metadata) {
+    m_ird->PopulateFromResultSetMetadata(pendingPrepare->metadata->get());
+  }
+}
+
+void ODBCStatement::SetParamsetStatuses(SQLULEN succeeded, SQLULEN processed) {
+  processed = std::min(processed, m_paramsetSize);
+  succeeded = std::min(succeeded, processed);
+  m_ipd->SetRowsProcessed(processed);
+
+  SQLUSMALLINT* statuses = m_ipd->GetArrayStatusPtr();
+  if (statuses) {
+    std::fill(statuses, statuses + succeeded, static_cast<SQLUSMALLINT>(SQL_PARAM_SUCCESS));
+    std::fill(statuses + succeeded, statuses + processed, static_cast<SQLUSMALLINT>(SQL_PARAM_ERROR));
+    std::fill(statuses + processed, statuses + m_paramsetSize, static_cast<SQLUSMALLINT>(SQL_PARAM_UNUSED));
+  }
+}
+
+bool ODBCStatement::RunExecution(SQLUSMALLINT function,
+                                 const std::function<std::shared_ptr<ResultSet>()>& execution) {
+  std::shared_ptr<ResultSet> result;
+  if (m_asyncExecution.valid()) {
+    // The application is polling an execution started by an earlier call.
+    if (function != m_asyncFunction) {
+      throw DriverException("Function sequence error", "HY010");
+    }
+    if (m_asyncExecution.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return false;
+    }
+    if (m_asyncCancelled) {
+      // The result of a cancelled execution is dropped, as is its error.
+      try {
+        result = m_asyncExecution.get();
+        if (result) {
+          result->Close();
+        }
+      } catch (...) {
+      }
+      throw DriverException("Operation canceled", "HY008");
+    }
+    // Rethrows any error raised by the execution.
+    result = m_asyncExecution.get();
+  } else if (m_asyncEnable == SQL_ASYNC_ENABLE_ON) {
+    m_asyncFunction = function;
+    m_asyncCancelled = false;
+    m_asyncExecution = std::async(std::launch::async, execution);
+    return false;
+  } else {
+    result = execution();
+  }
+
+  m_currenResult = std::move(result);
+  if (m_currenResult) {
     m_ird->PopulateFromResultSetMetadata(m_currenResult->GetMetadata().get());
     m_hasReachedEndOfResult = false;
   }
+  return true;
+}
+
+void ODBCStatement::CheckNotExecuting() const {
+  if (IsStillExecuting()) {
+    throw DriverException("Function sequence error", "HY010");
+  }
+}
+
+SQLULEN ODBCStatement::GetParameterBindings(std::vector<ParameterBinding>& bindings) {
+  const std::vector<DescriptorRecord>& records = m_currentApd->GetRecords();
+
+  size_t parameterCount = records.size();
+  while (parameterCount > 0 && !records[parameterCount - 1].m_isBound) {
+    --parameterCount;
+  }
+
+  bindings.clear();
+  bindings.reserve(parameterCount);
+  for (size_t i = 0; i < parameterCount; ++i) {
+    const DescriptorRecord& record = records[i];
+    if (!record.m_isBound) {
+      throw DriverException("Parameter " + std::to_string(i + 1) + " is not bound", "07002");
+    }
+    bindings.push_back(ParameterBinding{record.m_type, record.m_precision, record.m_scale,
+                                        record.m_dataPtr, static_cast<ssize_t>(GetLength(record)),
+                                        record.m_indicatorPtr});
+  }
+
+  return bindings.empty() ? 0 : std::max<SQLULEN>(m_currentApd->GetArraySize(), 1);
+}
+
+void ODBCStatement::ExecuteDirect(const std::string& query) {
+  std::shared_ptr<Statement> spiStatement = m_spiStatement;
+  if (!RunExecution(SQL_API_SQLEXECDIRECT, [spiStatement, query]() {
+        return spiStatement->Execute(query) ? spiStatement->GetResultSet() : nullptr;
+      })) {
+    return;
+  }
 
   // Direct execution wipes out the prepared state.
   m_isPrepared = false;
+  m_needsServerPrepare = false;
 }
 
 bool ODBCStatement::Fetch(size_t rows) {
+  CheckNotExecuting();
+  if (!m_currenResult) {
+    throw DriverException("Invalid cursor state", "24000");
+  }
+
   if (m_hasReachedEndOfResult) {
+    // The cursor is now after the end, which SQL_FETCH_PRIOR relies on.
+    m_lastFetchedRows = 0;
     m_ird->SetRowsProcessed(0);
     return false;
   }
@@ -304,15 +515,174 @@ bool ODBCStatement::Fetch(size_t rows) {
     m_currentArd->NotifyBindingsHavePropagated();
   }
 
-  size_t rowsFetched = m_currenResult->Move(rows, m_currentArd->GetBindOffset(),
-                                            m_currentArd->GetBoundStructOffset(), m_ird->GetArrayStatusPtr());
+  size_t rowsFetched;
+  if (m_retrieveData == SQL_RD_OFF) {
+    // Only position the cursor, leaving bound buffers untouched.
+    rowsFetched = m_currenResult->Skip(rows, m_ird->GetArrayStatusPtr());
+  } else {
+    rowsFetched = m_currenResult->Move(rows, m_currentArd->GetBindOffset(),
+                                       m_currentArd->GetBoundStructOffset(), m_ird->GetArrayStatusPtr());
+  }
   m_ird->SetRowsProcessed(static_cast<SQLULEN>(rowsFetched));
 
   m_rowNumber += rowsFetched;
+  m_lastFetchedRows = rowsFetched;
   m_hasReachedEndOfResult = rowsFetched != rows;
+
+  // Rows past the limit are never returned, so stop the streams instead of
+  // letting them transfer the rest of the result. The current rowset stays
+  // readable through GetData.
+  if (m_maxRows && m_rowNumber >= m_maxRows && !m_hasReachedEndOfResult) {
+    m_hasReachedEndOfResult = true;
+    m_currenResult->Cancel();
+  }
   return rowsFetched != 0;
 }
 
+bool ODBCStatement::FetchScroll(SQLSMALLINT orientation, SQLLEN offset, size_t rows) {
+  CheckNotExecuting();
+  if (orientation == SQL_FETCH_NEXT) {
+    return Fetch(rows);
+  }
+
+  if (m_cursorType == SQL_CURSOR_STATIC) {
+    return FetchStatic(orientation, offset, rows);
+  }
+
+  // The cursor is forward-only, so relative positioning can only skip ahead
+  // of the current rowset.
+  if (orientation != SQL_FETCH_RELATIVE) {
+    throw DriverException("Fetch type out of range", "HY106");
+  }
+
+  // Before the first fetch the rowset starts at row `offset`, otherwise at
+  // `offset` rows past the start of the current rowset.
+  SQLLEN rowsToSkip = m_rowNumber == 0 ? offset - 1 : offset - static_cast<SQLLEN>(m_lastFetchedRows);
+  if (rowsToSkip < 0) {
+    throw DriverException("Fetch type out of range", "HY106");
+  }
+
+  if (!m_currenResult) {
+    throw DriverException("Invalid cursor state", "24000");
+  }
+
+  if (m_hasReachedEndOfResult) {
+    m_ird->SetRowsProcessed(0);
+    return false;
+  }
+
+  size_t rowsAllowed = static_cast<size_t>(rowsToSkip);
+  if (m_maxRows) {
+    rowsAllowed = std::min(rowsAllowed, static_cast<size_t>(m_maxRows - m_rowNumber));
+  }
+
+  size_t rowsSkipped = rowsAllowed ? m_currenResult->Skip(rowsAllowed, nullptr) : 0;
+  m_rowNumber += rowsSkipped;
+  if (rowsSkipped != static_cast<size_t>(rowsToSkip)) {
+    m_lastFetchedRows = 0;
+    m_hasReachedEndOfResult = true;
+    m_ird->SetRowsProcessed(0);
+    return false;
+  }
+
+  return Fetch(rows);
+}
+
+bool ODBCStatement::FetchStatic(SQLSMALLINT orientation, SQLLEN offset, size_t rows) {
+  if (!m_currenResult) {
+    throw DriverException("Invalid cursor state", "24000");
+  }
+
+  // Rows are counted from 0 here, and a negative start is before the first
+  // row. The current rowset starts at currentStart.
+  const SQLLEN rowsetSize = static_cast<SQLLEN>(rows);
+  const bool beforeStart = m_rowNumber == 0 && m_lastFetchedRows == 0 && !m_hasReachedEndOfResult;
+  const bool afterEnd = m_hasReachedEndOfResult && m_lastFetchedRows == 0;
+  const SQLLEN currentStart = static_cast<SQLLEN>(m_rowNumber - m_lastFetchedRows);
+
+  SQLLEN start;
+  switch (orientation) {
+    case SQL_FETCH_FIRST:
+      start = 0;
+      break;
+    case SQL_FETCH_LAST:
+      start = std::max<SQLLEN>(CountResultRows() - rowsetSize, 0);
+      break;
+    case SQL_FETCH_ABSOLUTE:
+      if (offset > 0) {
+        start = offset - 1;
+      } else if (offset < 0) {
+        start = CountResultRows() + offset;
+        if (start < 0 && -offset <= rowsetSize) {
+          start = 0;
+        }
+      } else {
+        start = -1;
+      }
+      break;
+    case SQL_FETCH_PRIOR:
+      if (afterEnd) {
+        start = std::max<SQLLEN>(CountResultRows() - rowsetSize, 0);
+      } else if (beforeStart || currentStart == 0) {
+        start = -1;
+      } else {
+        start = std::max<SQLLEN>(currentStart - rowsetSize, 0);
+      }
+      break;
+    case SQL_FETCH_RELATIVE:
+      // Moving back from the first rowset goes before the start, moving back
+      // past it from a later one stops at the first rowset.
+      start = (beforeStart ? -1 : currentStart) + offset;
+      if (start < 0 && !beforeStart && currentStart > 0 && -offset <= rowsetSize) {
+        start = 0;
+      }
+      break;
+    default:
+      throw DriverException("Fetch type out of range", "HY106");
+  }
+
+  if (start < 0) {
+    // A following SQL_FETCH_NEXT returns the first rowset.
+    m_currenResult->Seek(0);
+    m_rowNumber = 0;
+    m_lastFetchedRows = 0;
+    m_hasReachedEndOfResult = false;
+    m_ird->SetRowsProcessed(0);
+    return false;
+  }
+
+  if ((m_maxRows && static_cast<SQLULEN>(start) >= m_maxRows) ||
+      !m_currenResult->Seek(static_cast<size_t>(start))) {
+    m_rowNumber = static_cast<SQLULEN>(CountResultRows());
+    m_lastFetchedRows = 0;
+    m_hasReachedEndOfResult = true;
+    m_ird->SetRowsProcessed(0);
+    return false;
+  }
+
+  m_rowNumber = static_cast<SQLULEN>(start);
+  m_lastFetchedRows = 0;
+  m_hasReachedEndOfResult = false;
+  return Fetch(rows);
+}
+
+SQLLEN ODBCStatement::CountResultRows() {
+  SQLULEN rowCount = static_cast<SQLULEN>(m_currenResult->CountRows());
+  if (m_maxRows) {
+    rowCount = std::min(rowCount, m_maxRows);
+  }
+  return static_cast<SQLLEN>(rowCount);
+}
+
+void ODBCStatement::SetCursorType(SQLULEN cursorType) {
+  m_spiStatement->SetAttribute(Statement::SCROLLABLE, static_cast<size_t>(cursorType == SQL_CURSOR_STATIC));
+  m_cursorType = cursorType;
+}
+
+SQLLEN ODBCStatement::GetRowCount() {
+  return static_cast<SQLLEN>(m_spiStatement->GetUpdateCount());
+}
+
 void ODBCStatement::GetStmtAttr(SQLINTEGER statementAttribute,
                                 SQLPOINTER output, SQLINTEGER bufferSize,
                                 SQLINTEGER *strLenPtr, bool isUnicode) {
@@ -330,7 +700,7 @@ void ODBCStatement::GetStmtAttr(SQLINTEGER statementAttribute,
       DescriptorToHandle(output, m_ipd.get(), strLenPtr);
       return;
     case SQL_ATTR_IMP_ROW_DESC:
-      DescriptorToHandle(output, m_ird.get(), strLenPtr);
+      DescriptorToHandle(output, GetIRD(), strLenPtr);
       return;
 
     // Attributes that are descriptor fields
@@ -372,7 +742,7 @@ void ODBCStatement::GetStmtAttr(SQLINTEGER statementAttribute,
       return;
 
     case SQL_ATTR_ASYNC_ENABLE:
-      GetAttribute(static_cast<SQLULEN>(SQL_ASYNC_ENABLE_OFF), output, bufferSize, strLenPtr);
+      GetAttribute(m_asyncEnable, output, bufferSize, strLenPtr);
       return;
 
 #ifdef SQL_ATTR_ASYNC_STMT_EVENT
@@ -388,15 +758,17 @@ void ODBCStatement::GetStmtAttr(SQLINTEGER statementAttribute,
       throw DriverException("Unsupported attribute", "HYC00");
 #endif
     case SQL_ATTR_CURSOR_SCROLLABLE:
-      GetAttribute(static_cast<SQLULEN>(SQL_NONSCROLLABLE), output, bufferSize, strLenPtr);
+      GetAttribute(static_cast<SQLULEN>(m_cursorType == SQL_CURSOR_STATIC ? SQL_SCROLLABLE : SQL_NONSCROLLABLE),
+                   output, bufferSize, strLenPtr);
       return;
 
     case SQL_ATTR_CURSOR_SENSITIVITY:
-      GetAttribute(static_cast<SQLULEN>(SQL_UNSPECIFIED), output, bufferSize, strLenPtr);
+      GetAttribute(static_cast<SQLULEN>(m_cursorType == SQL_CURSOR_STATIC ? SQL_INSENSITIVE : SQL_UNSPECIFIED),
+                   output, bufferSize, strLenPtr);
       return;
 
     case SQL_ATTR_CURSOR_TYPE:
-      GetAttribute(static_cast<SQLULEN>(SQL_CURSOR_FORWARD_ONLY), output, bufferSize, strLenPtr);
+      GetAttribute(m_cursorType, output, bufferSize, strLenPtr);
       return;
 
     case SQL_ATTR_ENABLE_AUTO_IPD:
@@ -427,12 +799,29 @@ void ODBCStatement::GetStmtAttr(SQLINTEGER statementAttribute,
       GetAttribute(static_cast<SQLULEN>(m_maxRows), output, bufferSize, strLenPtr);
       return;
     case SQL_ATTR_RETRIEVE_DATA:
-      GetAttribute(static_cast<SQLULEN>(SQL_RD_ON), output, bufferSize, strLenPtr);
+      GetAttribute(static_cast<SQLULEN>(m_retrieveData), output, bufferSize, strLenPtr);
       return;
     case SQL_ROWSET_SIZE:
       GetAttribute(static_cast<SQLULEN>(m_rowsetSize), output, bufferSize, strLenPtr);
       return;
 
+    case StatementAttribute_ARROW_ARRAY_STREAM:
+      if (!m_currenResult) {
+        throw DriverException("Invalid cursor state", "24000");
+      }
+      if (!output) {
+        throw DriverException("Invalid use of null pointer", "HY009");
+      }
+      {
+        // Rows past SQL_ATTR_MAX_ROWS are left out, as they are when fetched.
+        boost::optional<size_t> maxRows;
+        if (m_maxRows) {
+          maxRows = static_cast<size_t>(m_rowNumber < m_maxRows ? m_maxRows - m_rowNumber : 0);
+        }
+        m_currenResult->ExportArrowStream(static_cast<struct ArrowArrayStream *>(output), maxRows);
+      }
+      return;
+
     // Driver-level statement attributes. These are all SQLULEN attributes.
     case SQL_ATTR_MAX_LENGTH:
       spiAttribute = m_spiStatement->GetAttribute(Statement::MAX_LENGTH);
@@ -446,6 +835,9 @@ void ODBCStatement::GetStmtAttr(SQLINTEGER statementAttribute,
     case SQL_ATTR_QUERY_TIMEOUT:
       spiAttribute = m_spiStatement->GetAttribute(Statement::QUERY_TIMEOUT);
       break;
+    case StatementAttribute_UPDATE_HINT:
+      spiAttribute = m_spiStatement->GetAttribute(Statement::UPDATE_HINT);
+      break;
     default:
       throw DriverException("Invalid statement attribute: " + std::to_string(statementAttribute), "HY092");
   }
@@ -461,6 +853,9 @@ void ODBCStatement::GetStmtAttr(SQLINTEGER statementAttribute,
 
 void ODBCStatement::SetStmtAttr(SQLINTEGER statementAttribute, SQLPOINTER value,
                                 SQLINTEGER bufferSize, bool isUnicode) {
+  // The worker of an asynchronous execution reads the attributes.
+  CheckNotExecuting();
+
   size_t attributeToWrite = 0;
   bool successfully_written = false;
 
@@ -533,7 +928,16 @@ void ODBCStatement::SetStmtAttr(SQLINTEGER statementAttribute, SQLPOINTER value,
       m_ird->SetHeaderField(SQL_DESC_ROWS_PROCESSED_PTR, value, bufferSize);
       return;
 
-    case SQL_ATTR_ASYNC_ENABLE:
+    case SQL_ATTR_ASYNC_ENABLE: {
+      SQLULEN asyncEnable;
+      SetAttribute(value, asyncEnable);
+      if (asyncEnable != SQL_ASYNC_ENABLE_ON && asyncEnable != SQL_ASYNC_ENABLE_OFF) {
+        throw DriverException("Invalid attribute value", "HY024");
+      }
+      m_asyncEnable = asyncEnable;
+      return;
+    }
+
 #ifdef SQL_ATTR_ASYNC_STMT_EVENT
     case SQL_ATTR_ASYNC_STMT_EVENT:
       throw DriverException("Unsupported attribute", "HYC00");
@@ -549,15 +953,37 @@ void ODBCStatement::SetStmtAttr(SQLINTEGER statementAttribute, SQLPOINTER value,
     case SQL_ATTR_CONCURRENCY:
       CheckIfAttributeIsSetToOnlyValidValue(value, static_cast<SQLULEN>(SQL_CONCUR_READ_ONLY));
       return;
-    case SQL_ATTR_CURSOR_SCROLLABLE:
-      CheckIfAttributeIsSetToOnlyValidValue(value, static_cast<SQLULEN>(SQL_NONSCROLLABLE));
-      return;
-    case SQL_ATTR_CURSOR_SENSITIVITY:
-      CheckIfAttributeIsSetToOnlyValidValue(value, static_cast<SQLULEN>(SQL_UNSPECIFIED));
+    case SQL_ATTR_CURSOR_SCROLLABLE: {
+      SQLULEN scrollable;
+      SetAttribute(value, scrollable);
+      if (scrollable != SQL_SCROLLABLE && scrollable != SQL_NONSCROLLABLE) {
+        throw DriverException("Invalid attribute value", "HY024");
+      }
+      SetCursorType(scrollable == SQL_SCROLLABLE ? SQL_CURSOR_STATIC : SQL_CURSOR_FORWARD_ONLY);
       return;
-    case SQL_ATTR_CURSOR_TYPE:
-      CheckIfAttributeIsSetToOnlyValidValue(value, static_cast<SQLULEN>(SQL_CURSOR_FORWARD_ONLY));
+    }
+    case SQL_ATTR_CURSOR_SENSITIVITY: {
+      SQLULEN sensitivity;
+      SetAttribute(value, sensitivity);
+      if (sensitivity == SQL_INSENSITIVE) {
+        SetCursorType(SQL_CURSOR_STATIC);
+      } else if (sensitivity != SQL_UNSPECIFIED) {
+        throw DriverException("Optional feature not implemented", "HYC00");
+      }
       return;
+    }
+    case SQL_ATTR_CURSOR_TYPE: {
+      SQLULEN cursorType;
+      SetAttribute(value, cursorType);
+      if (cursorType != SQL_CURSOR_FORWARD_ONLY && cursorType != SQL_CURSOR_STATIC &&
+          cursorType != SQL_CURSOR_KEYSET_DRIVEN && cursorType != SQL_CURSOR_DYNAMIC) {
+        throw DriverException("Invalid attribute value", "HY024");
+      }
+      // Keyset-driven and dynamic cursors are substituted with a static one.
+      SetCursorType(cursorType == SQL_CURSOR_FORWARD_ONLY ? SQL_CURSOR_FORWARD_ONLY : SQL_CURSOR_STATIC);
+      successfully_written = cursorType == m_cursorType;
+      break;
+    }
     case SQL_ATTR_ENABLE_AUTO_IPD:
       CheckIfAttributeIsSetToOnlyValidValue(value, static_cast<SQLULEN>(SQL_FALSE));
       return;
@@ -577,15 +1003,24 @@ void ODBCStatement::SetStmtAttr(SQLINTEGER statementAttribute, SQLPOINTER value,
     case SQL_ATTR_USE_BOOKMARKS:
       CheckIfAttributeIsSetToOnlyValidValue(value, static_cast<SQLULEN>(SQL_UB_OFF));
       return;
-    case SQL_ATTR_RETRIEVE_DATA:
-      CheckIfAttributeIsSetToOnlyValidValue(value, static_cast<SQLULEN>(SQL_TRUE));
+    case SQL_ATTR_RETRIEVE_DATA: {
+      SQLULEN retrieveData;
+      SetAttribute(value, retrieveData);
+      if (retrieveData != SQL_RD_ON && retrieveData != SQL_RD_OFF) {
+        throw DriverException("Invalid attribute value", "HY024");
+      }
+      m_retrieveData = retrieveData;
       return;
+    }
     case SQL_ROWSET_SIZE:
       SetAttribute(value, m_rowsetSize);
       return;
 
     case SQL_ATTR_MAX_ROWS:
-      throw DriverException("Cannot set read-only attribute", "HY092");
+      SetAttribute(value, attributeToWrite);
+      successfully_written = m_spiStatement->SetAttribute(Statement::MAX_ROWS, attributeToWrite);
+      m_maxRows = attributeToWrite;
+      break;
 
     // Driver-leve statement attributes. These are all size_t attributes
     case SQL_ATTR_MAX_LENGTH:
@@ -604,6 +1039,10 @@ void ODBCStatement::SetStmtAttr(SQLINTEGER statementAttribute, SQLPOINTER value,
       SetAttribute(value, attributeToWrite);
       successfully_written = m_spiStatement->SetAttribute(Statement::QUERY_TIMEOUT, attributeToWrite);
       break;
+    case StatementAttribute_UPDATE_HINT:
+      SetAttribute(value, attributeToWrite);
+      successfully_written = m_spiStatement->SetAttribute(Statement::UPDATE_HINT, attributeToWrite);
+      break;
     default:
         throw DriverException("Invalid attribute: " + std::to_string(attributeToWrite), "HY092");
   }
@@ -621,6 +1060,9 @@ void ODBCStatement::RevertAppDescriptor(bool isApd) {
 }
 
 void ODBCStatement::closeCursor(bool suppressErrors) {
+  if (!suppressErrors) {
+    CheckNotExecuting();
+  }
   if (!suppressErrors && !m_currenResult) {
     throw DriverException("Invalid cursor state", "28000");
   }
@@ -633,10 +1075,27 @@ void ODBCStatement::closeCursor(bool suppressErrors) {
   // Reset the fetching state of this statement.
   m_currentArd->NotifyBindingsHaveChanged();
   m_rowNumber = 0;
+  m_lastFetchedRows = 0;
   m_hasReachedEndOfResult = false;
 }
 
+bool ODBCStatement::MoreResults() {
+  CheckNotExecuting();
+  closeCursor(true);
+
+  if (!m_spiStatement->MoreResults()) {
+    return false;
+  }
+
+  m_currenResult = m_spiStatement->GetResultSet();
+  if (m_currenResult) {
+    m_ird->PopulateFromResultSetMetadata(m_currenResult->GetMetadata().get());
+  }
+  return true;
+}
+
 bool ODBCStatement::GetData(SQLSMALLINT recordNumber, SQLSMALLINT cType, SQLPOINTER dataPtr, SQLLEN bufferLength, SQLLEN* indicatorPtr) {
+  CheckNotExecuting();
   if (recordNumber == 0) {
     throw DriverException("Bookmarks are not supported", "07009");
   } else if (recordNumber > m_ird->GetRecords().size()) {
@@ -683,13 +1142,20 @@ void ODBCStatement::releaseStatement() {
 
 void ODBCStatement::GetTables(const std::string* catalog, const std::string* schema, const std::string* table, const std::string* tableType) {
   closeCursor(true);
-  if (m_connection.IsOdbc2Connection()) {
-    m_currenResult = m_spiStatement->GetTables_V2(catalog, schema, table, tableType);
-  } else {
-    m_currenResult = m_spiStatement->GetTables_V3(catalog, schema, table, tableType);
+  // The arguments are copied since the worker may outlive the caller's strings.
+  std::shared_ptr<Statement> spiStatement = m_spiStatement;
+  bool isOdbc2 = m_connection.IsOdbc2Connection();
+  boost::optional<std::string> catalogArg = CopyArgument(catalog), schemaArg = CopyArgument(schema),
+                               tableArg = CopyArgument(table), tableTypeArg = CopyArgument(tableType);
+  if (!RunExecution(SQL_API_SQLTABLES, [=]() {
+        return isOdbc2
+                   ? spiStatement->GetTables_V2(ArgumentPtr(catalogArg), ArgumentPtr(schemaArg),
+                                                ArgumentPtr(tableArg), ArgumentPtr(tableTypeArg))
+                   : spiStatement->GetTables_V3(ArgumentPtr(catalogArg), ArgumentPtr(schemaArg),
+                                                ArgumentPtr(tableArg), ArgumentPtr(tableTypeArg));
+      })) {
+    return;
   }
-  m_ird->PopulateFromResultSetMetadata(m_currenResult->GetMetadata().get());
-  m_hasReachedEndOfResult = false;
 
   // Direct execution wipes out the prepared state.
   m_isPrepared = false;
@@ -697,13 +1163,19 @@ void ODBCStatement::GetTables(const std::string* catalog, const std::string* sch
 
 void ODBCStatement::GetColumns(const std::string* catalog, const std::string* schema, const std::string* table, const std::string* column) {
   closeCursor(true);
-  if (m_connection.IsOdbc2Connection()) {
-    m_currenResult = m_spiStatement->GetColumns_V2(catalog, schema, table, column);
-  } else {
-    m_currenResult = m_spiStatement->GetColumns_V3(catalog, schema, table, column);
+  std::shared_ptr<Statement> spiStatement = m_spiStatement;
+  bool isOdbc2 = m_connection.IsOdbc2Connection();
+  boost::optional<std::string> catalogArg = CopyArgument(catalog), schemaArg = CopyArgument(schema),
+                               tableArg = CopyArgument(table), columnArg = CopyArgument(column);
+  if (!RunExecution(SQL_API_SQLCOLUMNS, [=]() {
+        return isOdbc2
+                   ? spiStatement->GetColumns_V2(ArgumentPtr(catalogArg), ArgumentPtr(schemaArg),
+                                                 ArgumentPtr(tableArg), ArgumentPtr(columnArg))
+                   : spiStatement->GetColumns_V3(ArgumentPtr(catalogArg), ArgumentPtr(schemaArg),
+                                                 ArgumentPtr(tableArg), ArgumentPtr(columnArg));
+      })) {
+    return;
   }
-  m_ird->PopulateFromResultSetMetadata(m_currenResult->GetMetadata().get());
-  m_hasReachedEndOfResult = false;
 
   // Direct execution wipes out the prepared state.
   m_isPrepared = false;
@@ -711,13 +1183,13 @@ void ODBCStatement::GetColumns(const std::string* catalog, const std::string* sc
 
 void ODBCStatement::GetTypeInfo(SQLSMALLINT dataType) {
   closeCursor(true);
-  if (m_connection.IsOdbc2Connection()) {
-    m_currenResult = m_spiStatement->GetTypeInfo_V2(dataType);
-  } else {
-    m_currenResult = m_spiStatement->GetTypeInfo_V3(dataType);
+  std::shared_ptr<Statement> spiStatement = m_spiStatement;
+  bool isOdbc2 = m_connection.IsOdbc2Connection();
+  if (!RunExecution(SQL_API_SQLGETTYPEINFO, [=]() {
+        return isOdbc2 ? spiStatement->GetTypeInfo_V2(dataType) : spiStatement->GetTypeInfo_V3(dataType);
+      })) {
+    return;
   }
-  m_ird->PopulateFromResultSetMetadata(m_currenResult->GetMetadata().get());
-  m_hasReachedEndOfResult = false;
 
   // Direct execution wipes out the prepared state.
   m_isPrepared = false;
@@ -726,22 +1198,38 @@ void ODBCStatement::GetTypeInfo(SQLSMALLINT dataType) {
 void ODBCStatement::GetForeignKeys(const std::string* pkCatalog, const std::string* pkSchema, const std::string* pkTable,
                                   const std::string* fkCatalog, const std::string* fkSchema, const std::string* fkTable) {
   closeCursor(true);
-  m_currenResult = m_spiStatement->GetForeignKeys(pkCatalog, pkSchema, pkTable, fkCatalog, fkSchema, fkTable);
-  m_ird->PopulateFromResultSetMetadata(m_currenResult->GetMetadata().get());
-  m_hasReachedEndOfResult = false;
+  std::shared_ptr<Statement> spiStatement = m_spiStatement;
+  boost::optional<std::string> pkCatalogArg = CopyArgument(pkCatalog), pkSchemaArg = CopyArgument(pkSchema),
+                               pkTableArg = CopyArgument(pkTable), fkCatalogArg = CopyArgument(fkCatalog),
+                               fkSchemaArg = CopyArgument(fkSchema), fkTableArg = CopyArgument(fkTable);
+  if (!RunExecution(SQL_API_SQLFOREIGNKEYS, [=]() {
+        return spiStatement->GetForeignKeys(ArgumentPtr(pkCatalogArg), ArgumentPtr(pkSchemaArg),
+                                            ArgumentPtr(pkTableArg), ArgumentPtr(fkCatalogArg),
+                                            ArgumentPtr(fkSchemaArg), ArgumentPtr(fkTableArg));
+      })) {
+    return;
+  }
 
   m_isPrepared = false;
 }
 
 void ODBCStatement::GetPrimaryKeys(const std::string* catalog, const std::string* schema, const std::string* table) {
   closeCursor(true);
-  m_currenResult = m_spiStatement->GetPrimaryKeys(catalog, schema, table);
-  m_ird->PopulateFromResultSetMetadata(m_currenResult->GetMetadata().get());
-  m_hasReachedEndOfResult = false;
+  std::shared_ptr<Statement> spiStatement = m_spiStatement;
+  boost::optional<std::string> catalogArg = CopyArgument(catalog), schemaArg = CopyArgument(schema),
+                               tableArg = CopyArgument(table);
+  if (!RunExecution(SQL_API_SQLPRIMARYKEYS, [=]() {
+        return spiStatement->GetPrimaryKeys(ArgumentPtr(catalogArg), ArgumentPtr(schemaArg), ArgumentPtr(tableArg));
+      })) {
+    return;
+  }
 
   m_isPrepared = false;
 }
 
 void ODBCStatement::Cancel() {
+  // The worker can't be interrupted, so an asynchronous execution is only
+  // flagged here and its result dropped once it completes.
+  m_asyncCancelled = true;
   m_spiStatement->Cancel();
 }